@@ -0,0 +1,33 @@
+#ifndef PERCEPTION_ETFLAB_MARKER_ARRAY_PUBLISHER_H
+#define PERCEPTION_ETFLAB_MARKER_ARRAY_PUBLISHER_H
+
+#include <chrono>
+#include <memory>
+#include <string>
+
+#include <rclcpp/rclcpp.hpp>
+#include <visualization_msgs/msg/marker_array.hpp>
+
+namespace perception_etflab
+{
+    // Publisher of marker arrays for RViz, which publishes only when somebody listens, 
+    // only when the content changes, and at most at 'max_rate'.
+    class MarkerArrayPublisher
+    {
+    public:
+        MarkerArrayPublisher() {}
+
+        void init(rclcpp::Node *node, const std::string &topic, float max_rate = 10);
+        bool isActive() const;
+        bool publish(const visualization_msgs::msg::MarkerArray &marker_array_msg);
+
+    private:
+        rclcpp::Publisher<visualization_msgs::msg::MarkerArray>::SharedPtr publisher;
+        visualization_msgs::msg::MarkerArray last_marker_array_msg;
+        std::chrono::steady_clock::time_point time_last;
+        std::chrono::nanoseconds min_period;
+        size_t num_subscribers;
+    };
+}
+
+#endif // PERCEPTION_ETFLAB_MARKER_ARRAY_PUBLISHER_H
@@ -22,6 +22,7 @@ namespace perception_etflab
 		std::string base_frame;
 		std::string output_topic;
 		std::map<std::string, pcl::PointCloud<pcl::PointXYZRGB>::Ptr> point_clouds;
+		std::map<std::string, builtin_interfaces::msg::Time> point_cloud_stamps;	// Capture times of 'point_clouds'
 
 		void pointCloudCallback(const sensor_msgs::msg::PointCloud2::SharedPtr msg);
 		void publishPoints();
@@ -9,6 +9,8 @@
 #include <sensor_msgs/msg/point_cloud2.hpp>
 #include <control_msgs/msg/joint_trajectory_controller_state.hpp>
 #include <visualization_msgs/msg/marker_array.hpp>
+
+#include "MarkerArrayPublisher.h"
 #include <pcl/point_cloud.h>
 #include <pcl_conversions/pcl_conversions.h>
 
@@ -25,6 +27,7 @@ namespace perception_etflab
 
 		inline float getTableRadius() const { return table_radius; }
         inline size_t getNumDOFs() const { return num_DOFs; }
+        inline float getVisualizationMaxRate() const { return visualization_max_rate; }
 
 		void jointsStateCallback(const control_msgs::msg::JointTrajectoryControllerState::SharedPtr msg);
 		void removeFromScene(std::vector<pcl::PointCloud<pcl::PointXYZRGB>::Ptr> &clusters);
@@ -34,7 +37,7 @@ namespace perception_etflab
 		void visualizeSkeleton();
 
 		rclcpp::Subscription<control_msgs::msg::JointTrajectoryControllerState>::SharedPtr joints_state_subscription;
-		rclcpp::Publisher<visualization_msgs::msg::MarkerArray>::SharedPtr marker_array_publisher;
+		perception_etflab::MarkerArrayPublisher marker_array_publisher;
 
     private:
 		std::shared_ptr<robots::AbstractRobot> robot;
@@ -45,5 +48,6 @@ namespace perception_etflab
         std::vector<float> tolerance_radius;
 		float table_radius;
         size_t num_DOFs;
+        float visualization_max_rate;   // Max. publishing rate of RViz markers in [Hz]
     };
 }
\ No newline at end of file
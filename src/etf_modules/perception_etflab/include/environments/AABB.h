@@ -10,6 +10,8 @@
 #include <pcl/common/common.h>
 #include <visualization_msgs/msg/marker_array.hpp>
 
+#include "MarkerArrayPublisher.h"
+
 namespace perception_etflab
 {
     class AABB
@@ -20,11 +22,11 @@ namespace perception_etflab
         inline pcl::PointCloud<pcl::PointXYZ>::Ptr getBoxes() const { return boxes; }
 
 		void make(const std::vector<pcl::PointCloud<pcl::PointXYZRGB>::Ptr> &clusters);
-        void publish();
+        void publish(const builtin_interfaces::msg::Time &stamp);
 		void visualize();
 
 		rclcpp::Publisher<sensor_msgs::msg::PointCloud2>::SharedPtr publisher;
-		rclcpp::Publisher<visualization_msgs::msg::MarkerArray>::SharedPtr marker_array_publisher;
+		perception_etflab::MarkerArrayPublisher marker_array_publisher;
 
     private:
         pcl::PointCloud<pcl::PointXYZ>::Ptr boxes;
@@ -10,6 +10,8 @@
 #include <pcl/common/common.h>
 #include <visualization_msgs/msg/marker_array.hpp>
 
+#include "MarkerArrayPublisher.h"
+
 #include <pcl/features/normal_3d.h>
 #include <pcl/common/transforms.h>
 #include <pcl/surface/convex_hull.h>
@@ -31,7 +33,7 @@ namespace perception_etflab
 
 		rclcpp::Publisher<sensor_msgs::msg::PointCloud2>::SharedPtr points_publisher;
 		rclcpp::Publisher<sensor_msgs::msg::PointCloud2>::SharedPtr polygons_publisher;
-		rclcpp::Publisher<visualization_msgs::msg::MarkerArray>::SharedPtr marker_array_publisher;
+		perception_etflab::MarkerArrayPublisher marker_array_publisher;
         
     private:
         pcl::PointCloud<pcl::PointXYZRGB>::Ptr points;
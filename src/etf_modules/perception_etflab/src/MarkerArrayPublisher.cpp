@@ -0,0 +1,41 @@
+#include "MarkerArrayPublisher.h"
+
+/// @brief Create the publisher on 'topic' using 'node'.
+/// @param node Node which owns the publisher.
+/// @param topic Topic name.
+/// @param max_rate Maximal publishing rate in [Hz]. Non-positive value means no throttling.
+void perception_etflab::MarkerArrayPublisher::init(rclcpp::Node *node, const std::string &topic, float max_rate)
+{
+    publisher = node->create_publisher<visualization_msgs::msg::MarkerArray>(topic, 10);
+    min_period = std::chrono::nanoseconds(max_rate > 0 ? size_t(1e9 / max_rate) : 0);
+    time_last = std::chrono::steady_clock::now() - min_period;
+    num_subscribers = 0;
+}
+
+// Whether it makes sense to build a new marker array at all. 
+// If false, all marker construction should be skipped.
+bool perception_etflab::MarkerArrayPublisher::isActive() const
+{
+    return publisher != nullptr && 
+           publisher->get_subscription_count() > 0 &&
+           std::chrono::steady_clock::now() - time_last >= min_period;
+}
+
+/// @brief Publish 'marker_array_msg' if it differs from the previously published one, 
+/// or if a new subscriber has appeared in the meantime.
+/// @return Whether the message is published.
+bool perception_etflab::MarkerArrayPublisher::publish(const visualization_msgs::msg::MarkerArray &marker_array_msg)
+{
+    size_t num_subscribers_new { publisher->get_subscription_count() };
+    if (marker_array_msg == last_marker_array_msg && num_subscribers_new <= num_subscribers)
+    {
+        num_subscribers = num_subscribers_new;
+        return false;
+    }
+
+    publisher->publish(marker_array_msg);
+    last_marker_array_msg = marker_array_msg;
+    time_last = std::chrono::steady_clock::now();
+    num_subscribers = num_subscribers_new;
+    return true;
+}
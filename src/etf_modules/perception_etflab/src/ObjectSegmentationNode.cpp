@@ -43,15 +43,15 @@ perception_etflab::ObjectSegmentationNode::ObjectSegmentationNode(const std::str
     
     Robot::joints_state_subscription = this->create_subscription<control_msgs::msg::JointTrajectoryControllerState>
 		("/xarm6_traj_controller/state", 10, std::bind(&Robot::jointsStateCallback, this, std::placeholders::_1));
-    Robot::marker_array_publisher = this->create_publisher<visualization_msgs::msg::MarkerArray>("/free_cells_vis_array", 10);
+	const float max_rate { Robot::getVisualizationMaxRate() };
+    Robot::marker_array_publisher.init(this, "/free_cells_vis_array", max_rate);
 	
     AABB::publisher = this->create_publisher<sensor_msgs::msg::PointCloud2>("/bounding_boxes", 10);
-    AABB::marker_array_publisher = this->create_publisher<visualization_msgs::msg::MarkerArray>("/occupied_cells_vis_array", 10);
+    AABB::marker_array_publisher.init(this, "/occupied_cells_vis_array", max_rate);
 
     ConvexHulls::points_publisher = this->create_publisher<sensor_msgs::msg::PointCloud2>("/convex_hulls", 10);
     ConvexHulls::polygons_publisher = this->create_publisher<sensor_msgs::msg::PointCloud2>("/convex_hulls_polygons", 10);
-	ConvexHulls::marker_array_publisher = this->create_publisher<visualization_msgs::msg::MarkerArray>("/occupied_cells_vis_array", 10);
-    
+	ConvexHulls::marker_array_publisher.init(this, "/convex_hulls_vis_array", max_rate);
 }
 
 void perception_etflab::ObjectSegmentationNode::realPointCloudCallback(const sensor_msgs::msg::PointCloud2::SharedPtr msg)
@@ -69,14 +69,14 @@ void perception_etflab::ObjectSegmentationNode::realPointCloudCallback(const sen
   	donwnsampler.setInputCloud(input_pcl_cloud);
   	donwnsampler.setLeafSize(0.01f, 0.01f, 0.01f);
   	donwnsampler.filter(*output_cloud);
-  	RCLCPP_INFO(rclcpp::get_logger("rclcpp"), "Downsampled the dataset using a leaf size of 1 [cm].");
+  	RCLCPP_DEBUG(rclcpp::get_logger("rclcpp"), "Downsampled the dataset using a leaf size of 1 [cm].");
   	
   	pcl::PointCloud<pcl::PointXYZRGB>::Ptr output_cloud_xyzrgb1(new pcl::PointCloud<pcl::PointXYZRGB>), 
 										   output_cloud_xyzrgb2(new pcl::PointCloud<pcl::PointXYZRGB>),
   										   output_cloud_xyzrgb3(new pcl::PointCloud<pcl::PointXYZRGB>);
   										   
   	pcl::fromPCLPointCloud2(*output_cloud, *output_cloud_xyzrgb1);
-  	RCLCPP_INFO(rclcpp::get_logger("rclcpp"), "After downsampling, point cloud size is %ld.", output_cloud_xyzrgb1->size());
+  	RCLCPP_DEBUG(rclcpp::get_logger("rclcpp"), "After downsampling, point cloud size is %ld.", output_cloud_xyzrgb1->size());
   	
 	// Green color filtering
   	pcl::ConditionalRemoval<pcl::PointXYZRGB> color_filter;
@@ -95,7 +95,7 @@ void perception_etflab::ObjectSegmentationNode::realPointCloudCallback(const sen
     passThroughZAxis.setFilterLimits(-0.05, 1.5);
   	passThroughZAxis.setInputCloud(output_cloud_xyzrgb1);
   	passThroughZAxis.filter(*output_cloud_xyzrgb2);
-  	RCLCPP_INFO(rclcpp::get_logger("rclcpp"), "After green filtering, point cloud size is %ld.", output_cloud_xyzrgb2->size());
+  	RCLCPP_DEBUG(rclcpp::get_logger("rclcpp"), "After green filtering, point cloud size is %ld.", output_cloud_xyzrgb2->size());
   	
   	pcl::ModelCoefficients::Ptr coefficients(new pcl::ModelCoefficients());
   	pcl::PointIndices::Ptr inliers(new pcl::PointIndices());
@@ -132,12 +132,12 @@ void perception_etflab::ObjectSegmentationNode::realPointCloudCallback(const sen
     Clusters::computeSubclusters(pcl_clusters, pcl_subclusters);
 
     AABB::make(pcl_subclusters);
-    AABB::publish();
+    AABB::publish(msg->header.stamp);
     AABB::visualize();
  
    	RCLCPP_INFO(rclcpp::get_logger("rclcpp"), "Time elapsed: %ld [ms] ", 
 		std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - time_start).count());
-   	RCLCPP_INFO(rclcpp::get_logger("rclcpp"), "---------------------------------------------------------------------");
+   	RCLCPP_DEBUG(rclcpp::get_logger("rclcpp"), "---------------------------------------------------------------------");
 }
 
 void perception_etflab::ObjectSegmentationNode::simPointCloudCallback()
@@ -154,7 +154,7 @@ void perception_etflab::ObjectSegmentationNode::simPointCloudCallback()
   	publishObjectsPointCloud(pcl_clusters);
 
     AABB::make(pcl_clusters);
-    AABB::publish();
+    AABB::publish(this->now());
     AABB::visualize();
 
     // ConvexHulls::make(pcl_clusters);
@@ -163,7 +163,7 @@ void perception_etflab::ObjectSegmentationNode::simPointCloudCallback()
  
    	RCLCPP_INFO(rclcpp::get_logger("rclcpp"), "Time elapsed: %ld [ms] ", 
 		std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - time_start).count());
-   	RCLCPP_INFO(rclcpp::get_logger("rclcpp"), "---------------------------------------------------------------------");
+   	RCLCPP_DEBUG(rclcpp::get_logger("rclcpp"), "---------------------------------------------------------------------");
 }
 
 void perception_etflab::ObjectSegmentationNode::publishObjectsPointCloud(std::vector<pcl::PointCloud<pcl::PointXYZRGB>::Ptr> &clusters)
@@ -183,7 +183,7 @@ void perception_etflab::ObjectSegmentationNode::publishObjectsPointCloud(std::ve
     output_cloud_ros.header.frame_id = "world";
 	output_cloud_ros.header.stamp = now();
 	object_pcl_publisher->publish(output_cloud_ros);
-    RCLCPP_INFO(rclcpp::get_logger("rclcpp"), "Publishing output point cloud of size %ld...", pcl->size());
+    RCLCPP_DEBUG(rclcpp::get_logger("rclcpp"), "Publishing output point cloud of size %ld...", pcl->size());
 }
 
 void perception_etflab::ObjectSegmentationNode::removeOutliers(const pcl::PointCloud<pcl::PointXYZRGB>::Ptr pcl)
@@ -199,5 +199,5 @@ void perception_etflab::ObjectSegmentationNode::removeOutliers(const pcl::PointC
             	pcl->erase(pcl_point);
 	}
 
-  	RCLCPP_INFO(rclcpp::get_logger("rclcpp"), "After removing outliers, point cloud size is %ld.", pcl->size());
+  	RCLCPP_DEBUG(rclcpp::get_logger("rclcpp"), "After removing outliers, point cloud size is %ld.", pcl->size());
 }
@@ -46,6 +46,7 @@ void perception_etflab::PointCloudCombinerNode::pointCloudCallback(const sensor_
 	pcl::transformPointCloud(*pcl_cloud, *pcl_transformed_cloud, tf2::transformToEigen(transform_stamped_msg).matrix());
 
 	point_clouds[frame_id] = pcl_transformed_cloud;
+	point_cloud_stamps[frame_id] = msg->header.stamp;
 	publishPoints();
 }
 
@@ -58,11 +59,20 @@ void perception_etflab::PointCloudCombinerNode::publishPoints()
 	for (const auto &points_pair : point_clouds)
 		combined_pcl_cloud += *points_pair.second;
 
+	// The combined cloud is as old as its oldest part, so subscribers can compensate the latency (unstamped clouds are considered as fresh)
+	rclcpp::Time stamp { now() };
+	for (const auto &stamp_pair : point_cloud_stamps)
+	{
+		rclcpp::Time point_cloud_stamp { stamp_pair.second, stamp.get_clock_type() };
+		if (point_cloud_stamp.nanoseconds() > 0 && point_cloud_stamp < stamp)
+			stamp = point_cloud_stamp;
+	}
+
 	sensor_msgs::msg::PointCloud2 combined_cloud;
 	pcl::toROSMsg(combined_pcl_cloud, combined_cloud);
 
 	combined_cloud.header.frame_id = base_frame;
-	combined_cloud.header.stamp = now();
+	combined_cloud.header.stamp = stamp;
 
 	publisher->publish(combined_cloud);
 }
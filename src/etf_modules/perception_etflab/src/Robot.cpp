@@ -34,6 +34,14 @@ perception_etflab::Robot::Robot(const std::string &config_file_path)
             tolerance_radius.emplace_back(tolerance_radius_node[i].as<float>());
     }
 
+    visualization_max_rate = 10;
+    YAML::Node visualization_node { node["visualization"] };
+    if (visualization_node.IsDefined() && visualization_node["max_rate"].IsDefined())
+        visualization_max_rate = visualization_node["max_rate"].as<float>();
+    else
+        RCLCPP_WARN(rclcpp::get_logger("rclcpp"), "Max. visualization rate is not defined! Using default value of %f [Hz].", 
+            visualization_max_rate);
+
     // Uncomment if you are using 'removeFromScene3' function
     // xarm_client_node = std::make_shared<rclcpp::Node>("xarm_client_node");
     // xarm_client.init(xarm_client_node, "xarm");
@@ -99,7 +107,7 @@ void perception_etflab::Robot::removeFromScene(std::vector<pcl::PointCloud<pcl::
             }
         }
     }
-    RCLCPP_INFO(rclcpp::get_logger("rclcpp"), "After removing robot from the scene, there are %ld clusters.", clusters.size());
+    RCLCPP_DEBUG(rclcpp::get_logger("rclcpp"), "After removing robot from the scene, there are %ld clusters.", clusters.size());
 }
 
 // Remove all PCL points occupied by the robot's capsules.
@@ -135,7 +143,7 @@ void perception_etflab::Robot::removeFromScene2(const pcl::PointCloud<pcl::Point
             }
         }
     }
-    RCLCPP_INFO(rclcpp::get_logger("rclcpp"), "After removing robot from the scene, point cloud size is %ld.", pcl->size());
+    RCLCPP_DEBUG(rclcpp::get_logger("rclcpp"), "After removing robot from the scene, point cloud size is %ld.", pcl->size());
 }
 
 // This method requires using xarm_client.
@@ -181,11 +189,14 @@ void perception_etflab::Robot::removeFromScene3(std::vector<pcl::PointCloud<pcl:
             }
         }
     }
-    RCLCPP_INFO(rclcpp::get_logger("rclcpp"), "After removing robot from the scene, there are %ld clusters.", clusters.size());
+    RCLCPP_DEBUG(rclcpp::get_logger("rclcpp"), "After removing robot from the scene, there are %ld clusters.", clusters.size());
 }
 
 void perception_etflab::Robot::visualizeCapsules()
 {
+    if (!marker_array_publisher.isActive())
+        return;
+
     std::shared_ptr<Eigen::MatrixXf> skeleton = robot->computeSkeleton(joints_state);
     visualization_msgs::msg::MarkerArray marker_array_msg;
     visualization_msgs::msg::Marker marker;
@@ -247,12 +258,15 @@ void perception_etflab::Robot::visualizeCapsules()
         }
     }
 
-    marker_array_publisher->publish(marker_array_msg);
-    RCLCPP_INFO(rclcpp::get_logger("rclcpp"), "Visualizing robot capsules...");
+    if (marker_array_publisher.publish(marker_array_msg))
+        RCLCPP_DEBUG(rclcpp::get_logger("rclcpp"), "Visualizing robot capsules...");
 }
 
 void perception_etflab::Robot::visualizeSkeleton()
 {
+    if (!marker_array_publisher.isActive())
+        return;
+
     std::shared_ptr<Eigen::MatrixXf> skeleton = robot->computeSkeleton(joints_state);
     visualization_msgs::msg::MarkerArray marker_array_msg;
     visualization_msgs::msg::Marker marker;
@@ -296,6 +310,6 @@ void perception_etflab::Robot::visualizeSkeleton()
     marker.scale.z = 0.02;
     marker_array_msg.markers.emplace_back(marker);
 
-    marker_array_publisher->publish(marker_array_msg);
-    RCLCPP_INFO(rclcpp::get_logger("rclcpp"), "Visualizing robot skeleton...");
+    if (marker_array_publisher.publish(marker_array_msg))
+        RCLCPP_DEBUG(rclcpp::get_logger("rclcpp"), "Visualizing robot skeleton...");
 }
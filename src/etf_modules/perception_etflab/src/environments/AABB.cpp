@@ -12,7 +12,7 @@ void perception_etflab::AABB::make(const std::vector<pcl::PointCloud<pcl::PointX
     {
         // Compute AABB for each cluster
         pcl::getMinMax3D(*cluster, min_point, max_point);
-        RCLCPP_INFO(rclcpp::get_logger("rclcpp"), "AABB %ld. min: (%f, %f, %f), max: (%f, %f, %f)",
+        RCLCPP_DEBUG(rclcpp::get_logger("rclcpp"), "AABB %ld. min: (%f, %f, %f), max: (%f, %f, %f)",
             j++, min_point.x(), min_point.y(), min_point.z(), max_point.x(), max_point.y(), max_point.z());
 
         dim.x = max_point.x() - min_point.x();
@@ -31,43 +31,69 @@ void perception_etflab::AABB::make(const std::vector<pcl::PointCloud<pcl::PointX
 
 }
 
-void perception_etflab::AABB::publish()
+/// @brief Publish bounding boxes.
+/// @param stamp Time when the point cloud, from which the boxes are computed, is captured. 
+/// It allows subscribers to compensate the latency of the whole perception pipeline.
+void perception_etflab::AABB::publish(const builtin_interfaces::msg::Time &stamp)
 {
     sensor_msgs::msg::PointCloud2 output_cloud_ros;
     pcl::toROSMsg(*boxes, output_cloud_ros);
-	// output_cloud_ros.header.stamp = now();
+	output_cloud_ros.header.stamp = stamp;
+	output_cloud_ros.header.frame_id = "world";
 	publisher->publish(output_cloud_ros);
-    RCLCPP_INFO(rclcpp::get_logger("rclcpp"), "Publishing %ld AABBs...", boxes->size() / 2);
+    RCLCPP_DEBUG(rclcpp::get_logger("rclcpp"), "Publishing %ld AABBs...", boxes->size() / 2);
 }
 
+// All AABBs are drawn as a single LINE_LIST marker (12 edges per box)
 void perception_etflab::AABB::visualize()
 {
+    if (!marker_array_publisher.isActive())
+        return;
+
     visualization_msgs::msg::MarkerArray marker_array_msg;
     visualization_msgs::msg::Marker marker;
-    marker.type = visualization_msgs::msg::Marker::CUBE;
+    marker.type = visualization_msgs::msg::Marker::LINE_LIST;
     marker.action = visualization_msgs::msg::Marker::ADD;
     marker.ns = "AABB";
+    marker.id = 0;
     marker.header.frame_id = "world";
     // marker.header.stamp = now();
     marker.pose.orientation.x = 0.0;
     marker.pose.orientation.y = 0.0;
     marker.pose.orientation.z = 0.0;
     marker.pose.orientation.w = 1.0;
+    marker.scale.x = 0.005;
     marker.color.r = 0.0;
     marker.color.g = 0.0;
     marker.color.b = 0.0;
-    marker.color.a = 0.5;
+    marker.color.a = 1.0;
+    marker.points.reserve(boxes->size() / 2 * 24);
+
+    geometry_msgs::msg::Point A {}, B {};
     for (size_t i = 0; i < boxes->size(); i += 2)
     {
-        marker.id = i / 2;
-        marker.scale.x = boxes->points[i].x;
-        marker.scale.y = boxes->points[i].y;
-        marker.scale.z = boxes->points[i].z;
-        marker.pose.position.x = boxes->points[i+1].x;
-        marker.pose.position.y = boxes->points[i+1].y;
-        marker.pose.position.z = boxes->points[i+1].z;
-        marker_array_msg.markers.emplace_back(marker);
+        const pcl::PointXYZ &dim { boxes->points[i] };
+        const pcl::PointXYZ &pos { boxes->points[i+1] };
+        for (size_t axis = 0; axis < 3; axis++)     // Edges parallel to 'axis'
+        {
+            for (size_t k = 0; k < 4; k++)
+            {
+                float sign1 { (k & 1) ? 0.5f : -0.5f };
+                float sign2 { (k & 2) ? 0.5f : -0.5f };
+                Eigen::Vector3f offset {};
+                offset(axis) = -0.5;
+                offset((axis + 1) % 3) = sign1;
+                offset((axis + 2) % 3) = sign2;
+                A.x = pos.x + offset.x() * dim.x; A.y = pos.y + offset.y() * dim.y; A.z = pos.z + offset.z() * dim.z;
+                offset(axis) = 0.5;
+                B.x = pos.x + offset.x() * dim.x; B.y = pos.y + offset.y() * dim.y; B.z = pos.z + offset.z() * dim.z;
+                marker.points.emplace_back(A);
+                marker.points.emplace_back(B);
+            }
+        }
     }
-    marker_array_publisher->publish(marker_array_msg);
-    RCLCPP_INFO(rclcpp::get_logger("rclcpp"), "Visualizing AABBs...");
+    marker_array_msg.markers.emplace_back(marker);
+
+    if (marker_array_publisher.publish(marker_array_msg))
+        RCLCPP_DEBUG(rclcpp::get_logger("rclcpp"), "Visualizing AABBs...");
 }
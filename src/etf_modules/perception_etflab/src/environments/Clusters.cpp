@@ -44,7 +44,7 @@ void perception_etflab::Clusters::computeClusters(const pcl::PointCloud<pcl::Poi
         cluster->is_dense = true;
         clusters.emplace_back(cluster);
     }
-    RCLCPP_INFO(rclcpp::get_logger("rclcpp"), "Point cloud is segmented into %ld clusters.", clusters.size());
+    RCLCPP_DEBUG(rclcpp::get_logger("rclcpp"), "Point cloud is segmented into %ld clusters.", clusters.size());
 }
 
 void perception_etflab::Clusters::computeSubclusters(const std::vector<pcl::PointCloud<pcl::PointXYZRGB>::Ptr> &clusters,
@@ -75,7 +75,7 @@ void perception_etflab::Clusters::computeSubclusters(const std::vector<pcl::Poin
         for (pcl::PointCloud<pcl::PointXYZRGB>::Ptr subcluster2 : subclusters2)
             divideCluster(subcluster2, subclusters, min_point(idx[2]), max_point(idx[2]), max_dim_subcluster(idx[2]), axes[idx[2]]);
     }
-    RCLCPP_INFO(rclcpp::get_logger("rclcpp"), "Clusters are divided into totally %ld subclusters.", subclusters.size());
+    RCLCPP_DEBUG(rclcpp::get_logger("rclcpp"), "Clusters are divided into totally %ld subclusters.", subclusters.size());
 }
 
 void perception_etflab::Clusters::divideCluster(const pcl::PointCloud<pcl::PointXYZRGB>::Ptr cluster, 
@@ -37,22 +37,27 @@ void perception_etflab::ConvexHulls::publish()
     pcl::toROSMsg(*points, output_cloud_ros);
 	// output_cloud_ros.header.stamp = now();
 	points_publisher->publish(output_cloud_ros);
-    RCLCPP_INFO(rclcpp::get_logger("rclcpp"), "Publishing %ld points of convex-hulls...", points->size());
+    RCLCPP_DEBUG(rclcpp::get_logger("rclcpp"), "Publishing %ld points of convex-hulls...", points->size());
 
     pcl::toROSMsg(*polygons_indices, output_cloud_ros);
 	// output_cloud_ros.header.stamp = now();
 	polygons_publisher->publish(output_cloud_ros);
-    RCLCPP_INFO(rclcpp::get_logger("rclcpp"), "Publishing %ld points of convex-hulls polygons indices...", polygons_indices->size());
+    RCLCPP_DEBUG(rclcpp::get_logger("rclcpp"), "Publishing %ld points of convex-hulls polygons indices...", polygons_indices->size());
 
 }
 
+// All convex-hulls are drawn as a single LINE_LIST marker containing the edges of their polygons
 void perception_etflab::ConvexHulls::visualize()
 {
+    if (!marker_array_publisher.isActive())
+        return;
+
     visualization_msgs::msg::MarkerArray marker_array_msg;
     visualization_msgs::msg::Marker marker;
-    marker.type = visualization_msgs::msg::Marker::LINE_STRIP;
+    marker.type = visualization_msgs::msg::Marker::LINE_LIST;
     marker.action = visualization_msgs::msg::Marker::ADD;
     marker.ns = "convex_hulls";
+    marker.id = 0;
     marker.header.frame_id = "world";
     // marker.header.stamp = now();
     marker.pose.position.x = 0.0;
@@ -63,33 +68,39 @@ void perception_etflab::ConvexHulls::visualize()
     marker.pose.orientation.z = 0.0;
     marker.pose.orientation.w = 1.0;
     marker.scale.x = 0.001;
-    marker.scale.y = 0.001;
-    marker.scale.z = 0.001;
     marker.color.r = 1.0;
     marker.color.g = 0.0;
     marker.color.b = 0.0;
     marker.color.a = 1.0;
     
-    size_t j = 0;
-    for (size_t i = 0; i < points->size(); i++)
+    // Polygon indices are relative to the first point of the corresponding cluster
+    size_t offset { 0 }, j { 0 };
+    geometry_msgs::msg::Point point {};
+    for (size_t i = 0; i < polygons_indices->size(); i++)
     {
-        pcl::PointXYZRGB P = points->points[i];
-        if (P.x == 0.0 && P.y == 0.0 && P.z == 0.0)     // This point is just delimiter to distinguish different clusters
+        pcl::PointXYZ P = polygons_indices->points[i];
+        if (P.x == -1)     // This point is just delimiter to distinguish different clusters
         {
-            marker.id = j++;
-            marker_array_msg.markers.emplace_back(marker);
-            marker.points.clear();
+            while (j < points->size() && !(points->points[j].x == 0.0 && points->points[j].y == 0.0 && points->points[j].z == 0.0))
+                j++;
+            offset = ++j;
+            continue;
         }
-        else
+
+        const size_t idx[3] = { offset + size_t(P.x), offset + size_t(P.y), offset + size_t(P.z) };
+        for (size_t k = 0; k < 3; k++)
         {
-            geometry_msgs::msg::Point point;
-            point.x = P.x; 
-            point.y = P.y; 
-            point.z = P.z;
-            marker.points.emplace_back(point);
+            for (size_t idx_ : { idx[k], idx[(k + 1) % 3] })
+            {
+                point.x = points->points[idx_].x;
+                point.y = points->points[idx_].y;
+                point.z = points->points[idx_].z;
+                marker.points.emplace_back(point);
+            }
         }
     }    
+    marker_array_msg.markers.emplace_back(marker);
 
-    marker_array_publisher->publish(marker_array_msg);
-    RCLCPP_INFO(rclcpp::get_logger("rclcpp"), "Visualizing convex-hulls...");
+    if (marker_array_publisher.publish(marker_array_msg))
+        RCLCPP_DEBUG(rclcpp::get_logger("rclcpp"), "Visualizing convex-hulls...");
 }
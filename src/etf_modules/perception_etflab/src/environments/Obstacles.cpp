@@ -91,7 +91,7 @@ void perception_etflab::Obstacles::move(std::vector<pcl::PointCloud<pcl::PointXY
                 point->y += velocities[i].y() * period;
                 point->z += velocities[i].z() * period;
             }
-            RCLCPP_INFO(rclcpp::get_logger("rclcpp"), "%ld. Obstacle pos: (%f, %f, %f)", i, pos.x(), pos.y(), pos.z());
+            RCLCPP_DEBUG(rclcpp::get_logger("rclcpp"), "%ld. Obstacle pos: (%f, %f, %f)", i, pos.x(), pos.y(), pos.z());
         }
     }
     clusters = obstacles;
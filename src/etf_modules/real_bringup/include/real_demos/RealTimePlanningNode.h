@@ -8,6 +8,7 @@ namespace real_bringup
     {
     public:
         RealTimePlanningNode(const std::string &node_name, const std::string &config_file_path, const std::string &output_file_name = "");
+        ~RealTimePlanningNode();
 
     protected:
         void computeTrajectory() override;
@@ -16,5 +17,6 @@ namespace real_bringup
         rclcpp::TimerBase::SharedPtr publishing_trajectory_timer;
         std::shared_ptr<rclcpp::Node> xarm_client_node;
         xarm_api::XArmROSClient xarm_client;
+        std::vector<float> servo_angles;    // Reused in each call of 'publishingTrajectoryCallback'
     };
 }
@@ -10,8 +10,9 @@ real_bringup::PickAndPlaceUsingCamerasNode::PickAndPlaceUsingCamerasNode(const s
     delta_z = scenario["delta_z"].as<float>();
     offset_z = scenario["offset_z"].as<float>();
 
+    AABB::clock = this->get_clock();
     AABB::subscription = this->create_subscription<sensor_msgs::msg::PointCloud2>
-        ("/bounding_boxes", 10, std::bind(&AABB::withFilteringCallback, this, std::placeholders::_1));
+        ("/bounding_boxes", 10, BaseNode::synchronized(this, &AABB::withFilteringCallback));
 
     task = waiting_for_object;
 }
@@ -6,6 +6,7 @@ real_bringup::RealTimePlanningNode::RealTimePlanningNode(const std::string &node
                                                          const std::string &output_file_name) : 
     sim_bringup::RealTimePlanningNode(node_name, config_file_path, output_file_name)
 {    
+    servo_angles = std::vector<float>(Robot::getNumDOFs(), 0);
     publishing_trajectory_timer = this->create_wall_timer(std::chrono::microseconds(size_t(Trajectory::getTrajectoryMaxTimeStep() * 1e6)), 
                                   std::bind(&RealTimePlanningNode::publishingTrajectoryCallback, this));
     
@@ -21,6 +22,11 @@ real_bringup::RealTimePlanningNode::RealTimePlanningNode(const std::string &node
     xarm_client.save_conf();
 }
 
+real_bringup::RealTimePlanningNode::~RealTimePlanningNode()
+{
+    BaseNode::stopRealTimeLoop();
+}
+
 void real_bringup::RealTimePlanningNode::computeTrajectory()
 {
     float t_delay { DP::updateCurrentState(true) };
@@ -34,18 +40,23 @@ void real_bringup::RealTimePlanningNode::computeTrajectory()
     DP::spline_next->setTimeStart(t_delay);
 }
 
+// The spline is taken from the snapshot handed off by the real-time loop, and it is evaluated at the current time
 void real_bringup::RealTimePlanningNode::publishingTrajectoryCallback()
 {
-    std::vector<float> position {};
-    float t { DP::spline_next->getTimeCurrent(true) + Trajectory::getTrajectoryMaxTimeStep() };
+    const Snapshot snapshot_ { getSnapshot() };
+    if (snapshot_.spline == nullptr)
+        return;
+    
+    float t { snapshot_.time_spline + std::chrono::duration<float>(std::chrono::steady_clock::now() - snapshot_.time_taken).count() 
+              + Trajectory::getTrajectoryMaxTimeStep() };
     // std::cout << "Time: " << t << " [s]\t Position: ";
     for (size_t i = 0; i < Robot::getNumDOFs(); i++)
     {
-        position.emplace_back(DP::spline_next->getPosition(t, i));
-        // std::cout << position[i] << " ";
+        servo_angles[i] = snapshot_.spline->getPosition(t, i);
+        // std::cout << servo_angles[i] << " ";
     }
     // std::cout << "\n";
     
-    // xarm_client.set_servo_angle_j(position);                                    // When using mode 1
-    xarm_client.set_servo_angle(position, Robot::getMaxVel(0), 0, 0, false);    // When using mode 6
+    // xarm_client.set_servo_angle_j(servo_angles);                                    // When using mode 1
+    xarm_client.set_servo_angle(servo_angles, Robot::getMaxVel(0), 0, 0, false);    // When using mode 6
 }
@@ -34,27 +34,20 @@ void real_bringup::TaskPlanningNode::taskPlanningCallback()
         break;
 
     case choosing_object:
-        obj_idx = chooseObject();
-        if (obj_idx != -1)
-        {
-            task = computing_IK;
-            IK_computed = computeObjectApproachAndPickStates();
-        }
-        else
-            task = waiting_for_object;
+        grasp_candidates = computeGraspCandidates();
+        task = grasp_candidates.empty() ? waiting_for_object : choosing_grasp;
         break;
 
-    case computing_IK:
-        if (IK_computed == 1)
+    case choosing_grasp:
+        if (takeNextGraspCandidate())
         {
             AABB::resetMeasurements();
             scenario->setStart(Robot::getJointsPositionPtr());
             scenario->setGoal(q_object_approach1);
             task = planning;
             task_next = going_towards_object;
-            IK_computed = -1;
         }
-        else if (IK_computed == 0)
+        else
             task = waiting_for_object;
         
         break;
@@ -102,11 +95,14 @@ void real_bringup::TaskPlanningNode::taskPlanningCallback()
         else
         {
             RCLCPP_INFO(rclcpp::get_logger("rclcpp"), "Moving the object to destination...");
+            task = planning;
+            task_next = releasing_object;
+            if (takePlannedNextLeg())
+                break;
+
             AABB::resetMeasurements();
             scenario->setStart(q_object_approach1);
             scenario->setGoal(q_goal);
-            task = planning;
-            task_next = releasing_object;
         }
         break;
     
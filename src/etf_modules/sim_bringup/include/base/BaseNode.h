@@ -7,9 +7,20 @@
 
 #include "base/Trajectory.h"
 #include "base/Planner.h"
+#include "base/Logger.h"
+#include "base/Histogram.h"
+#include "base/RealTime.h"
+#include "environments/Octomap.h"
+
+#include "state_spaces/RealVectorSpaceOctree.h"
 
 #include <RealVectorSpace.h>
 #include <RealVectorSpaceFCL.h>
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 using namespace std::chrono_literals;
 
@@ -25,12 +36,66 @@ namespace sim_bringup
 
         virtual void baseCallback() = 0;
 
+        inline bool isRealTimeLoop() const { return rt_loop; }
+        inline size_t getNumSkippedPeriods() const { return num_skipped_periods.load(std::memory_order_relaxed); }
+        sim_bringup::Histogram getJitterHistogram() const;
+        sim_bringup::Histogram getOverrunHistogram() const;
+
+        void startRealTimeLoop();
+        void stopRealTimeLoop();
+
+        /// @brief Wrap a member callback of 'object' (e.g., a subscription callback), so that it never runs
+        /// concurrently with 'baseCallback'. While the real-time loop is running, the call (with its arguments) is only put 
+        /// into 'pending_callbacks', and the loop runs all pending calls before its next iteration. Thus, the executor waits 
+        /// only for a swap of two buffers, and never for the iteration itself. Otherwise, the callback is called right away.
+        /// Callbacks which must keep their own rate (e.g., periodic trajectory publishing) should not be wrapped. 
+        /// They should rather read a snapshot of the data handed off at the end of each iteration.
+        template <typename Object, typename Class, typename... Args>
+        std::function<void(Args...)> synchronized(Object *object, void (Class::*callback)(Args...))
+        {
+            return [this, object, callback](Args... args)
+            {
+                std::lock_guard<std::mutex> lock(handoff_mutex);
+                if (rt_handoff)
+                    pending_callbacks.emplace_back([object, callback, args...]() { (object->*callback)(args...); });
+                else
+                    (object->*callback)(args...);
+            };
+        }
+
         rclcpp::TimerBase::SharedPtr timer;
+        rclcpp::TimerBase::SharedPtr streaming_timer;
         float period;                             // Period of basic callback function in [s]
 
     protected:
+        void realTimeLoop();
+        void updateOctree();
+        std::shared_ptr<base::StateSpace> createStateSpace(const std::shared_ptr<robots::AbstractRobot> &robot, 
+            const std::shared_ptr<env::Environment> &env) const;
+
         std::string project_abs_path;
+        std::string state_space;                  // Type of the state space
+
+        // Octomap whose updates are streamed from its topic (nullptr if streaming is not enabled)
+        std::shared_ptr<sim_bringup::Octomap> octomap;
 
+        // Real-time loop, where 'baseCallback' runs in a dedicated thread woken up at absolute deadlines,
+        // instead of a wall timer within the executor. Nodes which may be destroyed while rclcpp is still running
+        // should call 'stopRealTimeLoop' in their destructors, since the loop calls the overridden 'baseCallback'.
+        bool rt_loop;
+        int rt_priority;                          // SCHED_FIFO priority (0 - default scheduling)
+        int rt_cpu;                               // CPU to which the loop is pinned (-1 - not pinned)
+        bool rt_lock_memory;
+        std::thread rt_thread;
+        std::atomic<bool> rt_running;
+        std::mutex handoff_mutex;                 // Guards 'rt_handoff' and 'pending_callbacks' (never held during an iteration)
+        bool rt_handoff;                          // Whether wrapped callbacks are handed off to the real-time loop
+        std::vector<std::function<void()>> pending_callbacks;   // Filled by the executor
+        std::vector<std::function<void()>> running_callbacks;   // Swapped with 'pending_callbacks', and run by the real-time loop
+        mutable std::mutex statistics_mutex;      // Guards the histograms, which are written by the real-time loop
+        sim_bringup::Histogram jitter_histogram;  // Wake-up latency after each deadline in [us]
+        sim_bringup::Histogram overrun_histogram; // Time in [us] by which each iteration exceeds the period (0 if it does not)
+        std::atomic<size_t> num_skipped_periods;  // Written by the real-time loop, and may be read from any thread
     };
 }
 
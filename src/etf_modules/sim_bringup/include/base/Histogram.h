@@ -0,0 +1,36 @@
+#ifndef SIM_BRINGUP_HISTOGRAM_H
+#define SIM_BRINGUP_HISTOGRAM_H
+
+#include <string>
+#include <vector>
+
+namespace sim_bringup
+{
+    // Histogram with fixed-width bins, where the last bin collects all values out of range.
+    // Bins are allocated only in the constructor, so 'add' can be called from a real-time loop.
+    class Histogram
+    {
+    public:
+        Histogram(float bin_width_ = 100, size_t num_bins = 50);
+
+        inline size_t getNumSamples() const { return num_samples; }
+        inline float getMax() const { return max; }
+        inline float getMean() const { return (num_samples > 0) ? sum / num_samples : 0; }
+        inline float getBinWidth() const { return bin_width; }
+        inline const std::vector<size_t> &getBins() const { return bins; }
+
+        void add(float value);
+        void clear();
+        float getPercentile(float p) const;
+        std::string toString(const std::string &unit) const;
+
+    private:
+        float bin_width;
+        std::vector<size_t> bins;
+        size_t num_samples;
+        double sum;
+        float max;
+    };
+}
+
+#endif // SIM_BRINGUP_HISTOGRAM_H
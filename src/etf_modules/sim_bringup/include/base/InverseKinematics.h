@@ -0,0 +1,64 @@
+#ifndef SIM_BRINGUP_INVERSE_KINEMATICS_H
+#define SIM_BRINGUP_INVERSE_KINEMATICS_H
+
+#include <AbstractRobot.h>
+#include <RealVectorSpaceState.h>
+#include <kdl/frames.hpp>
+#include <Eigen/Eigen>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "base/ThreadPool.h"
+
+namespace sim_bringup
+{
+    // Inverse kinematics solver with seeded multi-start and memoisation.
+    // Several IK attempts (from different initial configurations) run in parallel, each with its own robot instance.
+    // Among the accepted solutions, the closest one to the reference configuration is chosen.
+    // Accepted solutions are cached by the quantised TCP pose. When the same pose is requested again, a cached solution is returned 
+    // directly if it is accepted and its TCP pose is within tolerance. Otherwise, cached solutions are used as first seeds.
+    class InverseKinematics
+    {
+    public:
+        // Whether a solution is acceptable (e.g., its wrist angle is convenient for grasping)
+        typedef std::function<bool(const std::shared_ptr<base::State> &)> Criterion;
+
+        InverseKinematics(const std::function<std::shared_ptr<robots::AbstractRobot>()> &robot_factory, size_t num_threads = 4,
+                          size_t num_attempts_ = 11, float position_resolution_ = 0.005, float orientation_resolution_ = 0.01);
+
+        inline size_t getNumHits() const { return num_hits; }
+        inline size_t getNumMisses() const { return num_misses; }
+
+        std::shared_ptr<base::State> solve(const KDL::Rotation &R, const KDL::Vector &p, const std::shared_ptr<base::State> &q_ref,
+                                           const Criterion &criterion = nullptr);
+        void clear();
+
+    private:
+        std::vector<int> quantise(const KDL::Rotation &R, const KDL::Vector &p) const;
+        bool isWithinTolerance(const std::shared_ptr<base::State> &q, const KDL::Rotation &R, const KDL::Vector &p) const;
+        std::shared_ptr<base::State> chooseClosest(const std::vector<std::shared_ptr<base::State>> &solutions,
+                                                   const std::shared_ptr<base::State> &q_ref) const;
+        void memorise(const std::vector<int> &key, const std::shared_ptr<base::State> &q);
+
+        struct KeyHash
+        {
+            size_t operator()(const std::vector<int> &key) const;
+        };
+
+        static constexpr float POSITION_TOLERANCE { 1e-3 };             // In [m]
+        static constexpr float ORIENTATION_TOLERANCE { 1e-3 };          // In [rad]
+
+        std::vector<std::shared_ptr<robots::AbstractRobot>> robots;     // One per thread
+        std::unique_ptr<sim_bringup::ThreadPool> thread_pool;
+        size_t num_attempts;
+        float position_resolution;                                      // In [m]
+        float orientation_resolution;                                   // Of rotation matrix elements
+        std::unordered_map<std::vector<int>, std::vector<Eigen::VectorXf>, KeyHash> solutions;
+        size_t num_hits;                                                // Number of 'solve' calls where a cached solution is used
+        size_t num_misses;
+    };
+}
+
+#endif // SIM_BRINGUP_INVERSE_KINEMATICS_H
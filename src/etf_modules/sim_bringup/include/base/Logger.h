@@ -0,0 +1,153 @@
+#ifndef SIM_BRINGUP_LOGGER_H
+#define SIM_BRINGUP_LOGGER_H
+
+#include <rclcpp/rclcpp.hpp>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <type_traits>
+
+namespace sim_bringup
+{
+    enum class LogLevel : uint8_t
+    {
+        Debug,
+        Info,
+        Warn,
+        Error,
+        None
+    };
+
+    // Low-overhead logger intended for hot loops (e.g., real-time planning callbacks).
+    // Logging a message only copies a fixed-size binary record (timestamp, level, pointer to the format literal
+    // and raw arithmetic arguments) into a lock-free bounded ring buffer. Formatting and printing are deferred
+    // to a background thread. If the buffer is full, the record is dropped and counted, so the caller never blocks.
+    // Use it through FAST_LOG_* macros, which are a single branch when the level is disabled, and nothing at all
+    // when SIM_BRINGUP_DISABLE_FAST_LOGGING is defined.
+    class Logger
+    {
+    public:
+        static constexpr size_t MAX_NUM_ARGS { 8 };
+        static constexpr size_t BUFFER_SIZE { 4096 };   // Must be a power of two
+        static constexpr std::chrono::milliseconds MAX_IDLE_SLEEP { 50 };  // Max. sleep of the background thread when idle
+
+        static Logger &getInstance();
+        static inline bool isEnabled(LogLevel level_) { return level_ >= level.load(std::memory_order_relaxed); }
+        static inline LogLevel getLevel() { return level.load(std::memory_order_relaxed); }
+        static inline void setLevel(LogLevel level_) { level.store(level_, std::memory_order_relaxed); }
+        static LogLevel toLevel(const std::string &level_str);
+
+        inline size_t getNumDropped() const { return num_dropped.load(std::memory_order_relaxed); }
+
+        /// @brief Store a record into the ring buffer. It does not allocate, format or make any system call.
+        /// @param level_ Severity level.
+        /// @param format printf-like format. Only a string literal is accepted, since just its address is stored.
+        /// @param args Arithmetic arguments (at most MAX_NUM_ARGS).
+        /// @return Whether the record is stored (false if the buffer is full).
+        template <size_t N, typename... Args>
+        bool log(LogLevel level_, const char (&format)[N], Args... args)
+        {
+            static_assert(sizeof...(Args) <= MAX_NUM_ARGS, "Too many arguments for binary logging!");
+            static_assert((std::is_arithmetic_v<Args> && ...), "Only arithmetic arguments are supported by binary logging!");
+
+            Record record;
+            record.time = std::chrono::duration_cast<std::chrono::nanoseconds>
+                (std::chrono::system_clock::now().time_since_epoch()).count();
+            record.format = format;
+            record.level = level_;
+            record.num_args = 0;
+            (setArg(record, args), ...);
+            return push(record);
+        }
+
+        void flush();
+
+    private:
+        enum class ArgType : uint8_t
+        {
+            Int,
+            UInt,
+            Float
+        };
+
+        union Arg
+        {
+            int64_t i;
+            uint64_t u;
+            double f;
+        };
+
+        struct Record
+        {
+            int64_t time;                               // System time in [ns]
+            const char *format;
+            LogLevel level;
+            uint8_t num_args;
+            std::array<ArgType, MAX_NUM_ARGS> types;
+            std::array<Arg, MAX_NUM_ARGS> args;
+        };
+
+        struct Cell
+        {
+            std::atomic<size_t> sequence;
+            Record record;
+        };
+
+        Logger();
+        ~Logger();
+        Logger(const Logger &) = delete;
+        Logger &operator=(const Logger &) = delete;
+
+        template <typename T>
+        static inline void setArg(Record &record, T arg)
+        {
+            if constexpr (std::is_floating_point_v<T>)
+            {
+                record.types[record.num_args] = ArgType::Float;
+                record.args[record.num_args].f = arg;
+            }
+            else if constexpr (std::is_signed_v<T>)
+            {
+                record.types[record.num_args] = ArgType::Int;
+                record.args[record.num_args].i = arg;
+            }
+            else
+            {
+                record.types[record.num_args] = ArgType::UInt;
+                record.args[record.num_args].u = arg;
+            }
+            record.num_args++;
+        }
+
+        bool push(const Record &record);
+        bool pop(Record &record);
+        void run();
+        static std::string toString(const Record &record);
+        static void print(const Record &record);
+
+        std::unique_ptr<Cell[]> buffer;
+        alignas(64) std::atomic<size_t> enqueue_pos;
+        alignas(64) std::atomic<size_t> dequeue_pos;
+        alignas(64) std::atomic<size_t> num_dropped;
+        std::atomic<bool> running;
+        std::thread thread;
+
+        inline static std::atomic<LogLevel> level { LogLevel::Info };
+    };
+}
+
+#ifdef SIM_BRINGUP_DISABLE_FAST_LOGGING
+#define FAST_LOG(level_, ...) ((void) 0)
+#else
+#define FAST_LOG(level_, ...) \
+    do { if (sim_bringup::Logger::isEnabled(level_)) sim_bringup::Logger::getInstance().log(level_, __VA_ARGS__); } while (0)
+#endif
+
+#define FAST_LOG_DEBUG(...) FAST_LOG(sim_bringup::LogLevel::Debug, __VA_ARGS__)
+#define FAST_LOG_INFO(...) FAST_LOG(sim_bringup::LogLevel::Info, __VA_ARGS__)
+#define FAST_LOG_WARN(...) FAST_LOG(sim_bringup::LogLevel::Warn, __VA_ARGS__)
+#define FAST_LOG_ERROR(...) FAST_LOG(sim_bringup::LogLevel::Error, __VA_ARGS__)
+
+#endif // SIM_BRINGUP_LOGGER_H
@@ -0,0 +1,35 @@
+#ifndef SIM_BRINGUP_NUM_DOFS_H
+#define SIM_BRINGUP_NUM_DOFS_H
+
+#include <Eigen/Eigen>
+#include <type_traits>
+
+namespace sim_bringup
+{
+    // Number of DOFs for which hot-path code is specialised at compile time (xArm6)
+    constexpr int NUM_DOFS_FIXED { 6 };
+
+    template <int N>
+    using VectorNf = Eigen::Matrix<float, N, 1>;
+
+    template <int N>
+    using VectorNd = Eigen::Matrix<double, N, 1>;
+
+    /// @brief Call 'func' with 'std::integral_constant<int, NUM_DOFS_FIXED>' if 'num_DOFs' equals 'NUM_DOFS_FIXED',
+    /// or with 'std::integral_constant<int, Eigen::Dynamic>' otherwise.
+    /// Inside 'func', 'decltype(N)::value' can be used as a size of fixed-size Eigen types (e.g., 'VectorNf', or 'Eigen::Map' of it),
+    /// which then live on the stack and are vectorised, while other robots fall back to dynamically sized ones.
+    /// @param num_DOFs Number of DOFs of the robot.
+    /// @param func Generic lambda taking the integral constant.
+    /// @return Whatever 'func' returns.
+    template <typename Func>
+    inline decltype(auto) dispatchNumDOFs(size_t num_DOFs, Func &&func)
+    {
+        if (num_DOFs == NUM_DOFS_FIXED)
+            return func(std::integral_constant<int, NUM_DOFS_FIXED> {});
+
+        return func(std::integral_constant<int, Eigen::Dynamic> {});
+    }
+}
+
+#endif // SIM_BRINGUP_NUM_DOFS_H
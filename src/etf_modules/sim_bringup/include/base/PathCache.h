@@ -0,0 +1,69 @@
+#ifndef SIM_BRINGUP_PATH_CACHE_H
+#define SIM_BRINGUP_PATH_CACHE_H
+
+#include <Environment.h>
+#include <Eigen/Eigen>
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace sim_bringup
+{
+    // Cache of found paths, keyed by quantised start and goal configurations, and by a hash of the static environment.
+    // Dynamic obstacles are not part of the key, so a cached path must be validated against the current environment before use.
+    // When the cache is full, the least recently used path is evicted.
+    class PathCache
+    {
+    public:
+        PathCache(float resolution_ = 0.05, size_t capacity_ = 100);
+
+        inline size_t size() const { return paths.size(); }
+        inline size_t getNumHits() const { return num_hits; }
+        inline size_t getNumMisses() const { return num_misses; }
+
+        const std::vector<Eigen::VectorXf> *find(const Eigen::VectorXf &q_start, const Eigen::VectorXf &q_goal, size_t env_hash);
+        void insert(const Eigen::VectorXf &q_start, const Eigen::VectorXf &q_goal, size_t env_hash,
+                    const std::vector<Eigen::VectorXf> &path);
+        void clear();
+        bool save(const std::string &file_path) const;
+        bool load(const std::string &file_path);
+
+        static size_t computeEnvironmentHash(const std::shared_ptr<env::Environment> &env);
+
+    private:
+        struct Key
+        {
+            std::vector<int> start;
+            std::vector<int> goal;
+            size_t env_hash;
+
+            bool operator==(const Key &other) const;
+        };
+
+        struct KeyHash
+        {
+            size_t operator()(const Key &key) const;
+        };
+
+        struct Entry
+        {
+            Key key;
+            std::vector<Eigen::VectorXf> path;
+        };
+
+        Key computeKey(const Eigen::VectorXf &q_start, const Eigen::VectorXf &q_goal, size_t env_hash) const;
+        std::vector<int> quantise(const Eigen::VectorXf &q) const;
+        void insert(Key &&key, const std::vector<Eigen::VectorXf> &path);
+
+        float resolution;                                               // In [rad]
+        size_t capacity;
+        std::list<Entry> paths;                                         // The most recently used is at the front
+        std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> entries;
+        size_t num_hits;
+        size_t num_misses;
+    };
+}
+
+#endif // SIM_BRINGUP_PATH_CACHE_H
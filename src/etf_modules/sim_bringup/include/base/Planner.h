@@ -5,14 +5,17 @@
 #ifndef SIM_BRINGUP_PLANNER_H
 #define SIM_BRINGUP_PLANNER_H
 
-#include <RRTConnect.h>
-#include <RBTConnect.h>
-#include <RGBTConnect.h>
-#include <RGBMTStar.h>
 #include <Scenario.h>
-#include <ConfigurationReader.h>
 #include <rclcpp/rclcpp.hpp>
 #include <yaml-cpp/yaml.h>
+#include <atomic>
+#include <functional>
+#include <mutex>
+
+#include "base/PlannerConfig.h"
+#include "base/PathCache.h"
+#include "base/Roadmap.h"
+#include "base/ThreadPool.h"
 
 namespace sim_bringup
 {
@@ -20,26 +23,66 @@ namespace sim_bringup
     {
     public:
         Planner(const std::string &config_file_path);
+        ~Planner();
 
         inline const std::unique_ptr<planning::AbstractPlanner> &getPlanner() const { return planner; }
-        inline planning::PlannerType getPlannerType() const { return planner_type; }
-        inline const std::vector<std::shared_ptr<base::State>> &getPath() const { return planner->getPath(); }
-        inline float getPlanningTime() const { return planner->getPlannerInfo()->getPlanningTime(); }
+        inline planning::PlannerType getPlannerType() const { return config.type; }
+        inline const sim_bringup::PlannerConfig &getConfig() const { return config; }
+        inline void setConfig(const sim_bringup::PlannerConfig &config_) { config = config_; }
+        inline const std::vector<std::shared_ptr<base::State>> &getPath() const { return path; }
+        inline float getPlanningTime() const { return planning_time; }
         inline bool isReady() const { return ready; }
+        inline bool isPortfolio() const { return !config.portfolio_types.empty(); }
 
         bool solve(std::shared_ptr<base::State> q_start = nullptr, std::shared_ptr<base::State> q_goal = nullptr, 
                    float max_planning_time_ = -1);
+        void cancel();
+        void initRoadmap();
         void preprocessPath(const std::vector<std::shared_ptr<base::State>> &original_path, 
             std::vector<std::shared_ptr<base::State>> &new_path, float max_edge_length_ = -1);
+        int preprocessAndValidatePath(const std::vector<std::shared_ptr<base::State>> &original_path, 
+            std::vector<std::shared_ptr<base::State>> &new_path, float max_edge_length_ = -1);
+        int validatePath(const std::vector<std::shared_ptr<base::State>> &path_);
+        std::vector<int> validatePaths(const std::vector<std::vector<std::shared_ptr<base::State>>> &paths);
+        void shortcutPath(std::vector<std::shared_ptr<base::State>> &path_, float max_time);
+        void smoothPath(std::vector<std::shared_ptr<base::State>> &path_, size_t num_iterations);
 
         std::shared_ptr<scenario::Scenario> scenario;
+        std::function<std::shared_ptr<base::StateSpace>()> state_space_factory;    // Creates an independent state space for parallel planning
 
     private:
+        static std::unique_ptr<planning::AbstractPlanner> createPlanner(planning::PlannerType type, 
+            const std::shared_ptr<base::StateSpace> &ss, const std::shared_ptr<base::State> &q_start, const std::shared_ptr<base::State> &q_goal);
+        bool solveFromScratch(const std::shared_ptr<base::State> &q_start, const std::shared_ptr<base::State> &q_goal, 
+                              float max_planning_time_, std::vector<std::shared_ptr<base::State>> &new_path);
+        bool findCachedPath(const std::shared_ptr<base::State> &q_start, const std::shared_ptr<base::State> &q_goal, size_t env_hash);
+        bool isPathValid(const std::vector<std::shared_ptr<base::State>> &path_) const;
+        bool repairPath(const std::shared_ptr<base::State> &q_start, const std::shared_ptr<base::State> &q_goal, 
+                        float max_planning_time_);
+        bool solvePortfolio(const std::shared_ptr<base::State> &q_start, const std::shared_ptr<base::State> &q_goal, 
+                            float max_planning_time_);
+        size_t acquireLease(const std::vector<planning::PlannerType> &types, float max_planning_time_);
+        void releaseLease(size_t lease);
+        float computePathCost(const std::vector<std::shared_ptr<base::State>> &path) const;
+        void prepareStateSpaces(std::vector<std::shared_ptr<base::StateSpace>> &state_spaces, size_t num) const;
+        static int validatePath(const std::shared_ptr<base::StateSpace> &ss, const std::vector<std::shared_ptr<base::State>> &path_,
+                                size_t idx_begin, size_t idx_end, const std::atomic<int> &idx_invalid);
+
         std::unique_ptr<planning::AbstractPlanner> planner;
-        planning::PlannerType planner_type;
-        float max_planning_time;                                        // In [s]
-        float max_edge_length;                                          // In [rad]
-        bool ready;
+        sim_bringup::PlannerConfig config;
+        std::vector<std::shared_ptr<base::State>> path;                 // The last found path (it is kept when planning fails)
+        float planning_time;                                            // In [s]
+        std::unique_ptr<sim_bringup::Roadmap> roadmap;
+        std::string roadmap_file;                                       // Absolute path (empty - the roadmap is not persisted)
+        std::unique_ptr<sim_bringup::PathCache> path_cache;
+        std::string path_cache_file;                                    // Absolute path (empty - the cache is not persisted)
+        std::vector<std::shared_ptr<base::StateSpace>> portfolio_state_spaces;
+        std::unique_ptr<sim_bringup::ThreadPool> thread_pool;
+        std::vector<std::shared_ptr<base::StateSpace>> validation_state_spaces;
+        std::unique_ptr<sim_bringup::ThreadPool> validation_thread_pool;
+        std::vector<size_t> leases;                                     // Leases of static settings held by running planners
+        std::mutex leases_mutex;
+        std::atomic<bool> ready;
     };
 }
 
@@ -0,0 +1,108 @@
+#ifndef SIM_BRINGUP_PLANNER_CONFIG_H
+#define SIM_BRINGUP_PLANNER_CONFIG_H
+
+#include <RRTConnect.h>
+#include <RBTConnect.h>
+#include <RGBTConnect.h>
+#include <RGBMTStar.h>
+#include <ConfigurationReader.h>
+#include <yaml-cpp/yaml.h>
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace sim_bringup
+{
+    // Settings of a single 'Planner' instance, read from the 'planner' node of a yaml file.
+    // Each instance owns its settings, so several planners in one process may use different ones.
+    struct PlannerConfig
+    {
+        planning::PlannerType type { planning::PlannerType::RGBTConnect };  // When 'use_roadmap' is true, it is used as a fallback
+        float max_planning_time { INFINITY };                   // In [s]
+        float max_edge_length { 0.1 };                          // In [rad]
+        bool terminate_when_path_is_found { false };            // Used only by RGBMT*
+        bool warm_start { false };                              // Whether to repair the previous path instead of planning from scratch
+
+        size_t num_validation_threads { 4 };                    // Number of threads for validating and shortcutting a path
+
+        // Post-processing of a found path: randomised shortcutting (in parallel), and then corner cutting (B-spline smoothing)
+        float shortcutting_time { 0 };                          // Time budget in [s] (0 - no shortcutting)
+        size_t shortcutting_max_idle_rounds { 3 };              // Consecutive rounds without a significant gain before stopping
+        size_t smoothing_iterations { 0 };
+
+        // Roadmap (planner type "PRM"): built once for the static environment, persisted in a file, and validated lazily
+        bool use_roadmap { false };
+        std::string roadmap_file {};                            // Relative to the project path (empty - not persisted)
+        size_t roadmap_num_nodes { 1000 };
+        size_t roadmap_num_neighbours { 10 };
+
+        // Path cache: found paths are stored (and reused if still valid) for repeated problems, optionally persisted in a file
+        bool use_path_cache { false };
+        std::string path_cache_file {};                         // Relative to the project path (empty - not persisted)
+        float path_cache_resolution { 0.05 };                   // In [rad]
+        size_t path_cache_capacity { 100 };
+
+        // Portfolio planning: several planners (of different types, or several seeds of the same type) are run in parallel,
+        // each with its own state space. Either the first found path is taken (and others are cancelled),
+        // or the path with the lowest cost when all of them terminate.
+        std::vector<planning::PlannerType> portfolio_types {};
+        bool portfolio_first_path { true };
+
+        static PlannerConfig load(const YAML::Node &planner_node);
+        static planning::PlannerType toPlannerType(const std::string &type);
+    };
+
+    // RPMPL planners read their settings from static '*Config' classes, which are shared by the whole process.
+    // This is the only place where they are written, always under 'mutex'. However, running RPMPL planners read them
+    // without any lock, so they must not change in a way that affects a running planner. Thus:
+    //  - Each 'solve' holds one lease, which writes the settings of all its planner types once before the planners are launched.
+    //    All members of a portfolio share this lease, i.e., the same (immutable) settings.
+    //  - Each lease has its own deadline. The time limit of a planner type is set to the largest configured limit among
+    //    the active leases using it, so it never cuts any of them short. A planner is terminated at its own deadline
+    //    by the watchdog thread, which cancels its lease. Thus, concurrent planners with different time limits do not conflict.
+    //  - Cancelling a lease lowers the time limit of its planner types to the largest one of the other active leases using them 
+    //    (or zero if there is none). Thus, a cancelled planner may run until that limit while another planner of its type is running.
+    //  - Only a different 'terminate_when_path_is_found' for RGBMT*, or a cancelled lease of the same type (whose time limit 
+    //    may already be zero), makes 'acquire' wait. The wait is bounded by 'MAX_WAIT_TIME', after which the lease
+    //    proceeds with the settings of the running planners.
+    // 'DRGBTConfig' is not leased. It is written once (under 'mutex') by the node running DRGBT, which is single per process.
+    class StaticPlannerConfig
+    {
+    public:
+        static void initConfiguration(const std::string &configurations_file_path);
+        static size_t acquire(const PlannerConfig &config, const std::vector<planning::PlannerType> &types, float max_planning_time);
+        static void release(size_t lease);
+        static void cancel(size_t lease);
+        static inline std::mutex &getMutex() { return mutex; }
+
+    private:
+        struct Lease
+        {
+            std::vector<planning::PlannerType> types;
+            float max_planning_time;                            // Configured time limit in [s]
+            std::chrono::steady_clock::time_point deadline;     // When the lease is cancelled by the watchdog
+            bool terminate_when_path_is_found;
+            bool cancelled;
+        };
+
+        static constexpr std::chrono::milliseconds MAX_WAIT_TIME { 1000 };
+
+        static bool isCompatible(const Lease &lease);
+        static void cancel(Lease &lease);
+        static void updateMaxPlanningTime(planning::PlannerType type);
+        static void setMaxPlanningTime(planning::PlannerType type, float time);
+        static void watchdog();
+
+        static std::mutex mutex;
+        static std::condition_variable released;
+        static std::condition_variable leases_changed;          // Wakes up the watchdog
+        static std::map<size_t, Lease> leases;
+        static size_t next_lease;
+        static bool watchdog_running;
+    };
+}
+
+#endif // SIM_BRINGUP_PLANNER_CONFIG_H
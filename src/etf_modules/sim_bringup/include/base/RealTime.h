@@ -0,0 +1,16 @@
+#ifndef SIM_BRINGUP_REAL_TIME_H
+#define SIM_BRINGUP_REAL_TIME_H
+
+#include <pthread.h>
+
+namespace sim_bringup
+{
+    // Helpers for configuring threads that run on a real-time budget.
+    // They only report (and return false) when the OS does not allow the setting (e.g., missing CAP_SYS_NICE or rtprio limits),
+    // so the caller may continue with the default scheduling.
+    bool setThreadAffinity(pthread_t thread, int cpu);
+    bool setThreadPriority(pthread_t thread, int priority);
+    bool lockMemory();
+}
+
+#endif // SIM_BRINGUP_REAL_TIME_H
@@ -0,0 +1,64 @@
+#ifndef SIM_BRINGUP_REPLANNING_WORKER_H
+#define SIM_BRINGUP_REPLANNING_WORKER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace sim_bringup
+{
+    // Token shared between the worker and a job. The job should check it before publishing any result,
+    // and may check it during long computations to terminate early.
+    class CancellationToken
+    {
+    public:
+        CancellationToken() : cancelled(std::make_shared<std::atomic<bool>>(false)) {}
+
+        inline bool isCancelled() const { return cancelled->load(std::memory_order_acquire); }
+        inline void cancel() const { cancelled->store(true, std::memory_order_release); }
+
+    private:
+        std::shared_ptr<std::atomic<bool>> cancelled;
+    };
+
+    // Persistent thread which executes replanning jobs, so no thread is created within the control loop.
+    // Jobs are passed through a single-slot mailbox: submitting a new job replaces the pending one (if any)
+    // and cancels the running one, since only the latest request is relevant to the control loop.
+    class ReplanningWorker
+    {
+    public:
+        typedef std::function<void(const CancellationToken &)> Job;
+
+        ReplanningWorker(const std::function<void()> &on_cancel_ = nullptr);
+        ~ReplanningWorker();
+        ReplanningWorker(const ReplanningWorker &) = delete;
+        ReplanningWorker &operator=(const ReplanningWorker &) = delete;
+
+        inline bool isBusy() const { return busy.load(std::memory_order_acquire); }
+
+        void start(int cpu = -1, int priority = 0);
+        void stop();
+        void submit(Job job);
+        void cancel();
+
+    private:
+        void run();
+        void cancelRunningJob();
+
+        std::function<void()> on_cancel;    // Called when the running job is cancelled (e.g., to make the planner terminate)
+        std::thread thread;
+        std::mutex mutex;
+        std::condition_variable condition;
+        Job pending_job;
+        CancellationToken pending_token;
+        CancellationToken running_token;
+        bool has_running_job;
+        bool running;
+        std::atomic<bool> busy;
+    };
+}
+
+#endif // SIM_BRINGUP_REPLANNING_WORKER_H
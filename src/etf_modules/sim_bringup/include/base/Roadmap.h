@@ -0,0 +1,61 @@
+#ifndef SIM_BRINGUP_ROADMAP_H
+#define SIM_BRINGUP_ROADMAP_H
+
+#include <StateSpace.h>
+#include <Eigen/Eigen>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace sim_bringup
+{
+    // Multi-query roadmap (PRM) over the configuration space of the static environment.
+    // It is built once (all nodes and edges are collision-free w.r.t. static objects), and then persisted in a file.
+    // Queries use lazy validation: the shortest path in the roadmap is searched first, and only its nodes and edges
+    // are checked against the current (dynamic) environment. Invalid ones are removed for that query, and the search is repeated.
+    class Roadmap
+    {
+    public:
+        Roadmap(size_t num_nodes_ = 1000, size_t num_neighbours_ = 10);
+
+        inline bool empty() const { return nodes.empty(); }
+        inline size_t getNumNodes() const { return nodes.size(); }
+        inline size_t getEnvironmentHash() const { return env_hash; }
+
+        void build(const std::shared_ptr<base::StateSpace> &ss, size_t env_hash_);
+        bool solve(const std::shared_ptr<base::StateSpace> &ss, const Eigen::VectorXf &q_start, const Eigen::VectorXf &q_goal,
+                   float max_planning_time, std::vector<Eigen::VectorXf> &path);
+        bool save(const std::string &file_path) const;
+        bool load(const std::string &file_path);
+
+    private:
+        struct Edge
+        {
+            size_t node;
+            float length;
+        };
+
+        enum class Status { Unknown, Valid, Invalid };
+
+        std::vector<size_t> findNearest(const Eigen::VectorXf &q, size_t k, size_t num_searched) const;
+        void addEdge(size_t idx1, size_t idx2);
+        size_t addQueryNode(const Eigen::VectorXf &q, size_t num_nodes_static);
+        void removeQueryNodes(size_t num_nodes_static);
+        bool searchShortestPath(size_t idx_start, size_t idx_goal, std::vector<size_t> &path_indices) const;
+        Status &getEdgeStatus(size_t idx1, size_t idx2);
+
+        size_t num_nodes;
+        size_t num_neighbours;
+        size_t env_hash;                                                // Hash of the static environment used for building
+        std::vector<Eigen::VectorXf> nodes;
+        std::vector<std::vector<Edge>> edges;
+
+        // Query data: start and goal are temporarily appended as the last two nodes (with their edges)
+        std::vector<Status> nodes_status;
+        std::unordered_map<size_t, Status> edges_status;
+    };
+}
+
+#endif // SIM_BRINGUP_ROADMAP_H
@@ -17,6 +17,10 @@
 #include <control_msgs/msg/gripper_command.hpp>
 #include <rclcpp_action/rclcpp_action.hpp>
 
+#include "base/NumDOFs.h"
+#include "base/StateBuffer.h"
+#include "base/Histogram.h"
+
 #include <RealVectorSpaceState.h>
 #include <xArm6.h>
 
@@ -29,6 +33,7 @@ namespace sim_bringup
         ~Robot() {}
         
         inline std::shared_ptr<robots::AbstractRobot> getRobot() const { return robot; }
+        std::shared_ptr<robots::AbstractRobot> createRobot() const;
         inline std::shared_ptr<base::State> getJointsPositionPtr() const 
             { return std::make_shared<base::RealVectorSpaceState>(joints_position); }
         inline std::shared_ptr<base::State> getJointsVelocityPtr() const 
@@ -54,6 +59,10 @@ namespace sim_bringup
         inline float getMaxJerk(size_t num) const { return robot->getMaxJerk(num); }
         inline size_t getNumDOFs() const { return num_DOFs; }
 
+        inline const sim_bringup::Histogram &getJointsStateLatency() const { return joints_state_latency; }
+        bool getJointsState(const rclcpp::Time &time, Eigen::VectorXf &position, Eigen::VectorXf &velocity) const;
+        float getJointsStateAge(const rclcpp::Time &time) const;
+
         void jointsStateCallback(const control_msgs::msg::JointTrajectoryControllerState::SharedPtr msg);
         inline bool isReady() { return ready; }
         bool isReached(std::shared_ptr<base::State> q, float tol = 0.01);
@@ -62,9 +71,18 @@ namespace sim_bringup
         rclcpp::Subscription<control_msgs::msg::JointTrajectoryControllerState>::SharedPtr joints_state_subscription;
         std::shared_ptr<rclcpp::Node> gripper_node;
         rclcpp_action::Client<control_msgs::action::GripperCommand>::SharedPtr gripper_client;
+        rclcpp::Clock::SharedPtr clock;     // Clock of the node, which is used for timestamps (e.g., of the controller)
 
     private:
         std::shared_ptr<robots::AbstractRobot> robot;
+        std::string robot_type;
+        std::string urdf_path;
+        float gripper_length;   // in [m]
+        bool table_included;
+        std::vector<float> capsules_radius;
+        Eigen::VectorXf max_vel;
+        Eigen::VectorXf max_acc;
+        Eigen::VectorXf max_jerk;
         Eigen::VectorXf joints_position;
         Eigen::VectorXf joints_velocity;
         Eigen::VectorXf joints_acceleration;
@@ -72,6 +90,8 @@ namespace sim_bringup
         float max_lin_vel;      // in [m/s]
         float max_lin_acc;      // in [m/s²]
         float max_lin_jerk;     // in [m/s³]
+        sim_bringup::StateBuffer joints_state_buffer;       // Measured joint states with their (header) timestamps
+        sim_bringup::Histogram joints_state_latency;        // Time in [ms] from stamping a joint state until it is received
         bool ready;
         size_t num_DOFs;
     };
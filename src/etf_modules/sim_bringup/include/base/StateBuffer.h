@@ -0,0 +1,41 @@
+#ifndef SIM_BRINGUP_STATE_BUFFER_H
+#define SIM_BRINGUP_STATE_BUFFER_H
+
+#include <Eigen/Eigen>
+#include <vector>
+
+namespace sim_bringup
+{
+    // Bounded history of timestamped states (position and velocity), which can be queried at any time instance.
+    // Between two samples, the position is interpolated by a cubic Hermite polynomial (using both velocities).
+    // After the latest sample, the state is extrapolated with a constant velocity for at most 'max_extrapolation'.
+    // Buffers are allocated in the constructor, so adding and querying do not allocate.
+    class StateBuffer
+    {
+    public:
+        StateBuffer(size_t num_DOFs = 0, size_t capacity_ = 16, float max_extrapolation_ = 0.2);
+
+        inline bool empty() const { return size == 0; }
+        inline double getLatestTime() const { return times[idx(size - 1)]; }
+        inline const Eigen::VectorXf &getLatestPosition() const { return positions[idx(size - 1)]; }
+        inline float getMaxExtrapolation() const { return max_extrapolation; }
+        inline void setMaxExtrapolation(float max_extrapolation_) { max_extrapolation = max_extrapolation_; }
+
+        bool add(double time, const Eigen::VectorXf &position, const Eigen::VectorXf &velocity);
+        bool query(double time, Eigen::VectorXf &position, Eigen::VectorXf &velocity) const;
+        void clear();
+
+    private:
+        inline size_t idx(size_t k) const { return (head + k) % capacity; }     // Index of the k-th oldest sample
+
+        size_t capacity;
+        float max_extrapolation;                // In [s]
+        std::vector<double> times;              // In [s]
+        std::vector<Eigen::VectorXf> positions;
+        std::vector<Eigen::VectorXf> velocities;
+        size_t head;                            // Index of the oldest sample
+        size_t size;
+    };
+}
+
+#endif // SIM_BRINGUP_STATE_BUFFER_H
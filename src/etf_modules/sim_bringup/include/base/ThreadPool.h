@@ -0,0 +1,54 @@
+#ifndef SIM_BRINGUP_THREAD_POOL_H
+#define SIM_BRINGUP_THREAD_POOL_H
+
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace sim_bringup
+{
+    // Fixed number of persistent threads executing submitted tasks in FIFO order.
+    // Threads are created once, so running tasks in parallel (e.g., a portfolio of planners) does not create any thread.
+    class ThreadPool
+    {
+    public:
+        ThreadPool(size_t num_threads);
+        ~ThreadPool();
+        ThreadPool(const ThreadPool &) = delete;
+        ThreadPool &operator=(const ThreadPool &) = delete;
+
+        inline size_t getNumThreads() const { return threads.size(); }
+
+        /// @brief Queue 'task' for execution.
+        /// @return Future holding the result of 'task' (or the exception thrown by it).
+        template <typename Task>
+        std::future<std::invoke_result_t<Task>> submit(Task task)
+        {
+            auto packaged_task { std::make_shared<std::packaged_task<std::invoke_result_t<Task>()>>(std::move(task)) };
+            std::future<std::invoke_result_t<Task>> future { packaged_task->get_future() };
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                tasks.emplace([packaged_task]() { (*packaged_task)(); });
+            }
+            condition.notify_one();
+            return future;
+        }
+
+    private:
+        void run();
+
+        std::vector<std::thread> threads;
+        std::queue<std::function<void()>> tasks;
+        std::mutex mutex;
+        std::condition_variable condition;
+        bool running;
+    };
+}
+
+#endif // SIM_BRINGUP_THREAD_POOL_H
@@ -12,6 +12,11 @@
 #include <yaml-cpp/yaml.h>
 
 #include <Spline5.h>
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
 
 namespace sim_bringup
 {
@@ -19,7 +24,7 @@ namespace sim_bringup
     {
     public:
         Trajectory(const std::string &config_file_path);
-        ~Trajectory() {}
+        ~Trajectory();
         
         void addPoint(float time_instance, const Eigen::VectorXf &position);
         void addPoint(float time_instance, const Eigen::VectorXf &position, const Eigen::VectorXf &velocity);
@@ -33,15 +38,60 @@ namespace sim_bringup
         void addPath(const std::vector<std::shared_ptr<base::State>> &path, bool must_visit);
 
         void publish(bool print = false);
+        void publishAt(std::chrono::steady_clock::time_point release_time);
+        void streamingCallback();
         void clear();
+        void reserve(size_t num_points);
         inline size_t getNumPoints() const { return msg.points.size(); }
         inline float getTrajectoryMaxTimeStep() const { return trajectory_max_time_step; }
+        inline float getTrajectoryMaxComputingTime() const { return trajectory_max_computing_time; }
+        inline float getTrajectoryTolerance() const { return trajectory_tolerance; }
+        inline void setTrajectoryMaxComputingTime(float time) { trajectory_max_computing_time = time; }
+        inline float getStreamingChunk() const { return streaming_chunk; }
+        inline bool isStreaming() const { return streaming; }
+        inline bool isPublishPending() const { return publish_pending; }
         
         rclcpp::Publisher<trajectory_msgs::msg::JointTrajectory>::SharedPtr publisher;
 
     private:
+        static constexpr size_t BATCH_SIZE { 16 };     // Number of time instances sampled at once in 'addPointsBatch'
+        static constexpr float MAX_ADAPTIVE_TIME_STEP { 0.5 };     // Max. time step in [s] in 'addPointsAdaptive'
+
+        trajectory_msgs::msg::JointTrajectoryPoint &newPoint(float time_instance);
+        template <int N>
+        size_t addPointsBatch(const std::shared_ptr<planning::trajectory::Spline> &spline, float t_offset, 
+                              float t_final, size_t num_points);
+        bool addPointsAdaptive(const std::shared_ptr<planning::trajectory::Spline> &spline, float t_offset, float t_final);
+        void computeWaypointVelocities(const std::vector<Eigen::VectorXf> &waypoints, std::vector<Eigen::VectorXf> &velocities);
+        void publishTrajectory(bool print);
+        void publishChunk();
+        void samplePoint(const trajectory_msgs::msg::JointTrajectoryPoint &point0, const trajectory_msgs::msg::JointTrajectoryPoint &point1, 
+                         float time_instance, trajectory_msgs::msg::JointTrajectoryPoint &point);
+        void publishingThread();
+        static inline float toSeconds(const builtin_interfaces::msg::Duration &duration) 
+            { return duration.sec + duration.nanosec * 1e-9; }
+
         trajectory_msgs::msg::JointTrajectory msg;
+        std::vector<trajectory_msgs::msg::JointTrajectoryPoint> spare_points;  // Points (with their buffers) kept from previous 'clear()'
         float trajectory_max_time_step;
+        float trajectory_max_computing_time;    // Time budget in [s] for 'addPath(path, must_visit)'
+        float trajectory_tolerance;             // Max. interpolation error in [rad] for adaptive sampling (0 means fixed time step)
+
+        trajectory_msgs::msg::JointTrajectory chunk_msg;
+        float streaming_chunk;                  // Duration in [s] of streamed chunks (0 means that the whole trajectory is published at once)
+        bool streaming;                         // Whether the trajectory from 'msg' is being streamed
+        size_t stream_idx;                      // Index of the first point from 'msg.points' after the current streaming time
+        rclcpp::Time stream_time_start;         // Time when the streamed trajectory starts
+        float stream_time_published;            // Time from start in [s] until which the trajectory is published
+
+        // Scheduled publishing: 'msg' is published by 'publish_thread' at 'publish_release_time', so the caller does not wait.
+        // 'publish_mutex' guards publishing and streaming against 'clear()', which cancels a pending publish.
+        std::mutex publish_mutex;
+        std::condition_variable publish_condition;
+        std::thread publish_thread;
+        std::chrono::steady_clock::time_point publish_release_time;
+        bool publish_pending;
+        bool publish_thread_running;
     };
 }
 
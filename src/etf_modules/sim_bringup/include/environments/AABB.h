@@ -14,6 +14,9 @@
 #include <pcl_conversions/pcl_conversions.h>
 #include <yaml-cpp/yaml.h>
 
+#include "base/Logger.h"
+#include "base/Histogram.h"
+
 namespace sim_bringup
 {
     class AABB
@@ -25,10 +28,19 @@ namespace sim_bringup
         inline const Eigen::Vector3f &getDimensions(size_t idx) const { return dimensions[idx]; }
         inline const std::vector<Eigen::Vector3f> &getPositions() const { return positions; }
         inline const Eigen::Vector3f &getPositions(size_t idx) const { return positions[idx]; }
+        inline const std::vector<Eigen::Vector3f> &getVelocities() const { return velocities; }
+        inline const Eigen::Vector3f &getVelocities(size_t idx) const { return velocities[idx]; }
         inline size_t getMinNumCaptures() const { return min_num_captures; }
+        inline float getPredictionHorizon() const { return prediction_horizon; }
+        inline double getTimeCapture() const { return time_capture; }
+        inline const sim_bringup::Histogram &getObstaclesLatency() const { return obstacles_latency; }
+        inline bool isLatencyCompensation() const { return latency_compensation; }
 
         inline void setEnvironment(const std::shared_ptr<env::Environment> &env_) { env = env_; }
         inline void setMinNumCaptures(size_t min_num_captures_) { min_num_captures = min_num_captures_; }
+        inline void setPredictionHorizon(float prediction_horizon_) { prediction_horizon = prediction_horizon_; }
+        inline void setLatencyCompensation(bool latency_compensation_) { latency_compensation = latency_compensation_; }
+        void setVelocities(const std::vector<Eigen::Vector3f> &velocities_);
 
         void updateEnvironment();
         void resetMeasurements();
@@ -36,16 +48,31 @@ namespace sim_bringup
         inline bool isReady() { return ready; }
         void callback(const sensor_msgs::msg::PointCloud2::SharedPtr msg);
         void withFilteringCallback(const sensor_msgs::msg::PointCloud2::SharedPtr msg);
+        void computeSweptBox(size_t idx, float delay, float horizon, Eigen::Vector3f &dim, Eigen::Vector3f &pos) const;
         
         rclcpp::Subscription<sensor_msgs::msg::PointCloud2>::SharedPtr subscription;
+        rclcpp::Clock::SharedPtr clock;     // Clock of the node, which is used to compute the age of captures
 
     protected:
         virtual bool whetherToRemove(const Eigen::Vector3f &object_pos, const Eigen::Vector3f &object_dim);
+        void estimateVelocities(double time_capture_);
+        double getCaptureTime(const sensor_msgs::msg::PointCloud2::SharedPtr &msg);
 
         std::vector<Eigen::Vector3f> dimensions;
         std::vector<Eigen::Vector3f> positions;
+        std::vector<Eigen::Vector3f> velocities;                // Estimated using constant-velocity model in [m/s]
         std::vector<size_t> num_captures;
         size_t min_num_captures;
+        std::vector<Eigen::Vector3f> dimensions_prev;           // Measurements from the previous capture
+        std::vector<Eigen::Vector3f> positions_prev;
+        std::vector<Eigen::Vector3f> velocities_prev;
+        double time_capture;                                    // Time in [s] when the current capture is taken (header stamp)
+        double time_capture_prev;
+        float max_obstacle_vel;                                 // Max. velocity in [m/s] when associating obstacles between captures
+        float prediction_horizon;                               // Obstacles are swept over this time horizon in [s] (0 means no prediction)
+        bool latency_compensation;                              // Whether obstacles are moved to where they are at the time of update
+        float max_latency_compensation;                         // Max. age in [s] of a capture which is compensated
+        sim_bringup::Histogram obstacles_latency;               // Age in [ms] of the capture when the environment is updated
         std::shared_ptr<env::Environment> env;
         bool ready;
     };
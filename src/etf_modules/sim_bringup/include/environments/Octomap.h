@@ -13,6 +13,9 @@
 #include <octomap_msgs/conversions.h>
 #include <visualization_msgs/msg/marker_array.hpp>
 #include <yaml-cpp/yaml.h>
+#include <atomic>
+#include <map>
+#include <mutex>
 
 namespace sim_bringup
 {
@@ -22,18 +25,42 @@ namespace sim_bringup
         Octomap(const std::string config_file_path);
 
         inline std::shared_ptr<fcl::OcTreef> getOctree() const { return octree; }
+        inline bool isStreaming() const { return streaming; }
+        inline const std::string &getOctomapTopic() const { return octomap_topic; }
+        inline size_t getNumUpdates() const { return num_updates.load(std::memory_order_relaxed); }
+        inline float getVisualizationRate() const { return visualization_rate; }
+        inline const std::string &getVisualizationTopic() const { return visualization_topic; }
 
         void read();
+        static std::shared_ptr<octomap::OcTree> deserialize(const octomap_msgs::msg::Octomap &octomap_msg);
+        void octreeCallback(const std::shared_ptr<octomap::OcTree> octomap_octree_new);
+        void applyPendingUpdate();
         void visualize();
+        void holdUpdates();
+        void resumeUpdates();
 
+        rclcpp::Subscription<octomap_msgs::msg::Octomap>::SharedPtr octomap_subscription;
         rclcpp::Publisher<visualization_msgs::msg::MarkerArray>::SharedPtr marker_array_publisher;    
+        rclcpp::TimerBase::SharedPtr visualization_timer;
 
     private:
+        void update(const std::shared_ptr<octomap::OcTree> &octomap_octree_new);
+
         std::shared_ptr<rclcpp::Node> read_node;
         rclcpp::Client<octomap_msgs::srv::GetOctomap>::SharedPtr client;
-        octomap::OcTree* octomap_octree;
-        std::shared_ptr<fcl::OcTreef> octree;
+        std::shared_ptr<octomap::OcTree> octomap_octree;    // Persistent tree which is updated in place
+        std::shared_ptr<fcl::OcTreef> octree;               // Single FCL wrapper around 'octomap_octree'
+        std::mutex octree_mutex;                            // Guards both trees against 'visualize', which may run in another thread
+        bool streaming;                                     // Whether octomap updates are received from 'octomap_topic'
+        std::string octomap_topic;
+        std::atomic<size_t> num_updates;
+        bool updates_held;                                  // Whether received updates are postponed until 'resumeUpdates'
+        std::shared_ptr<octomap::OcTree> pending_octree;    // The latest received tree which is not applied yet
+        size_t num_updates_visualized;                      // Value of 'num_updates' at the last visualization
+        size_t num_subscribers;                             // Number of subscribers at the last visualization
+        float visualization_rate;                           // Max. visualization rate in [Hz] (0 - no visualization)
+        std::string visualization_topic;
     };
 }
 
-#endif // SIM_BRINGUP_OCTOMAP_H
\ No newline at end of file
+#endif // SIM_BRINGUP_OCTOMAP_H
@@ -4,14 +4,12 @@
 
 #include "base/BaseNode.h"
 #include "environments/AABB.h"
-#include "environments/Octomap.h"
 #include "environments/ConvexHulls.h"
 
 namespace sim_bringup
 {
     class PlanningNode : public sim_bringup::BaseNode,
                          public sim_bringup::AABB,
-                         public sim_bringup::Octomap,
                          public sim_bringup::ConvexHulls
     {
     public:
@@ -20,6 +18,7 @@ namespace sim_bringup
     protected:
         virtual void baseCallback() override { planningCallback(); }
         virtual void planningCallback();
+        bool isPathStillValid();
 
         enum State
         {
@@ -4,9 +4,11 @@
 
 #include "base/BaseNode.h"
 #include "environments/AABB.h"
+#include "base/ReplanningWorker.h"
 
 #include <DRGBT.h>
-#include <thread>
+#include <atomic>
+#include <mutex>
 
 namespace sim_bringup
 {
@@ -16,20 +18,43 @@ namespace sim_bringup
     {
     public:
         RealTimePlanningNode(const std::string &node_name, const std::string &config_file_path, const std::string &output_file_name = "");
+        ~RealTimePlanningNode();
 
     protected:
-        void baseCallback() override { planningCallback(); }
+        void baseCallback() override { planningCallback(); handOffSnapshot(); }
         void planningCallback();
+        void handOffSnapshot();
         void taskComputingNextConfiguration();
         void taskReplanning();
         void replan(float max_planning_time) override;
         virtual void computeTrajectory();
         void recordingTrajectoryCallback();
 
-        int replanning_result;  //  0: replanning was not successful
-                                //  1: replanning was successful and predefined path needs to be updated
-                                // -1: replanning was successful but predefined path does not need to be updated
+        std::atomic<int> replanning_result;     //  0: replanning was not successful
+                                                //  1: replanning was successful and predefined path needs to be updated
+                                                // -1: replanning was successful but predefined path does not need to be updated
+        sim_bringup::ReplanningWorker replanning_worker;    // Runs replanning when FPS is used
+        std::shared_ptr<base::State> q_measured;            // Latest measured robot state (not extrapolated to the iteration start)
+        Eigen::VectorXf q_measured_vec;
+        Eigen::VectorXf q_measured_dot_vec;
         rclcpp::TimerBase::SharedPtr recording_trajectory_timer;
         std::ofstream output_file;
+
+        // Data handed off at the end of each iteration to the timer callbacks, which keep their own (higher) rate,
+        // and thus are not synchronized with the iteration. They only read a copy taken under 'snapshot_mutex'.
+        struct Snapshot
+        {
+            std::shared_ptr<planning::trajectory::Spline> spline { nullptr };  // 'DP::spline_next', which is not modified anymore
+            float time_spline { 0 };                                            // Current time in [s] of 'spline' when it is taken
+            float time_elapsed { 0 };                                           // Elapsed time in [s] of the algorithm when it is taken
+            std::chrono::steady_clock::time_point time_taken {};
+            size_t num_iterations { 0 };
+            Eigen::VectorXf joints_position {};                                 // Measured at the iteration
+            Eigen::VectorXf joints_velocity {};
+        };
+        Snapshot getSnapshot();
+
+        Snapshot snapshot;
+        std::mutex snapshot_mutex;
     };
 }
@@ -3,9 +3,24 @@
 //
 
 #include "sim_demos/PlanningNode.h"
+#include "base/InverseKinematics.h"
+
+#include <deque>
+#include <future>
 
 namespace sim_bringup
 {
+    // Grasp of the object 'obj_idx', with all configurations needed to pick it and to place it at the destination
+    struct GraspCandidate
+    {
+        size_t obj_idx;
+        Eigen::Vector3f obj_pos;                                        // Measurements are reset in the meantime
+        std::shared_ptr<base::State> q_approach1, q_approach2;
+        std::shared_ptr<base::State> q_pick;
+        std::shared_ptr<base::State> q_goal;
+        float cost;                                                     // Joint-space distance to be travelled
+    };
+
     class TaskPlanningNode : public sim_bringup::PlanningNode
     {
     public:
@@ -15,15 +30,20 @@ namespace sim_bringup
         void planningCallback() override { taskPlanningCallback(); }
         virtual void taskPlanningCallback();
         virtual void planningCase();
-        bool computeObjectApproachAndPickStates();
-        int chooseObject() override;
+        std::deque<sim_bringup::GraspCandidate> computeGraspCandidates();
+        bool computeGraspCandidate(size_t obj_idx_, int side, float yaw_offset, sim_bringup::GraspCandidate &candidate);
+        bool takeNextGraspCandidate();
+        bool isPickable(size_t idx) const;
+        void startPlanningNextLeg(const std::shared_ptr<base::State> &q_start, const std::shared_ptr<base::State> &q_goal_);
+        bool takePlannedNextLeg();
+        void discardPlannedNextLeg();
         bool whetherToRemove(const Eigen::Vector3f &object_pos, const Eigen::Vector3f &object_dim) override;
 
         enum Task 
         {
             waiting_for_object,
             choosing_object,
-            computing_IK,
+            choosing_grasp,
             going_towards_object,
             picking_object,
             raising_object,
@@ -37,8 +57,15 @@ namespace sim_bringup
         std::shared_ptr<base::State> q_object_pick;
         std::shared_ptr<base::State> q_goal;
         int obj_idx;
-        int IK_computed;
+        std::unique_ptr<sim_bringup::InverseKinematics> inverse_kinematics;
+        std::deque<sim_bringup::GraspCandidate> grasp_candidates;       // Ranked from the best one
+        std::vector<float> grasp_yaw_offsets;                           // Rotations of the gripper around its axis in [rad]
         float max_object_height;
         Eigen::Vector3f destination;
+
+        bool pipelined_planning;                                        // Whether the next leg is planned while the current one is executed
+        std::future<bool> next_leg;                                     // Result of planning the next leg in the background
+        std::shared_ptr<base::State> q_next_leg_start, q_next_leg_goal;
+        std::shared_ptr<base::State> q_leg_goal;                        // Goal of the leg being executed
     };
 }
@@ -0,0 +1,40 @@
+#ifndef SIM_BRINGUP_REAL_VECTOR_SPACE_OCTREE_H
+#define SIM_BRINGUP_REAL_VECTOR_SPACE_OCTREE_H
+
+#include <RealVectorSpace.h>
+#include <fcl/fcl.h>
+#include <array>
+#include <algorithm>
+
+namespace sim_bringup
+{
+    // Real vector space where, besides the objects from 'env', the robot's capsules are checked against an octree.
+    // The octree is expected to be given in the same (world) frame as the environment objects.
+    class RealVectorSpaceOctree : public base::RealVectorSpace
+    {
+    public:
+        RealVectorSpaceOctree(size_t num_dimensions_, const std::shared_ptr<robots::AbstractRobot> robot_, 
+                              const std::shared_ptr<env::Environment> env_);
+        ~RealVectorSpaceOctree() {}
+
+        inline std::shared_ptr<fcl::OcTreef> getOctree() const { return octree; }
+        inline void setOctree(const std::shared_ptr<fcl::OcTreef> octree_) { octree = octree_; }
+
+        bool isValid(const std::shared_ptr<base::State> q) override;
+        float computeDistance(const std::shared_ptr<base::State> q, bool compute_again = false) override;
+        float computeOctreeDistance(const std::shared_ptr<base::State> q, float d_max = INFINITY);
+        bool isInOctreeCollision(const std::shared_ptr<base::State> q);
+
+    private:
+        void computeOctreeDistance(const fcl::OcTreef::OcTreeNode* node, const fcl::AABBf &bv, 
+                                   const Eigen::Vector3f &A, const Eigen::Vector3f &B, float radius, float &d_c);
+        bool isInOctreeCollision(const fcl::OcTreef::OcTreeNode* node, const fcl::AABBf &bv, 
+                                 const Eigen::Vector3f &A, const Eigen::Vector3f &B, float radius);
+        static float distanceLineSegToAABB(const Eigen::Vector3f &A, const Eigen::Vector3f &B, const fcl::AABBf &bv);
+
+        std::shared_ptr<robots::AbstractRobot> robot_octree;
+        std::shared_ptr<fcl::OcTreef> octree;
+    };
+}
+
+#endif // SIM_BRINGUP_REAL_VECTOR_SPACE_OCTREE_H
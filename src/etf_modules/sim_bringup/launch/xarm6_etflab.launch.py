@@ -8,6 +8,7 @@
 
 import os
 from launch import LaunchDescription
+from launch.conditions import IfCondition
 from launch.actions import IncludeLaunchDescription, DeclareLaunchArgument, SetEnvironmentVariable, RegisterEventHandler, LogInfo, ExecuteProcess, TimerAction
 from launch.launch_description_sources import PythonLaunchDescriptionSource
 from launch.substitutions import LaunchConfiguration, ThisLaunchFileDir, Command, TextSubstitution
@@ -55,6 +56,7 @@ def generate_launch_description():
     camera_right_Y = LaunchConfiguration('camera_right_Y', default=3.5)
     
     use_sim_time = LaunchConfiguration('use_sim_time', default=True)
+    octomap = LaunchConfiguration('octomap', default=False)    # Whether to start the octomap server (e.g., for 'planning_config_octomap.yaml')
     
     # robot gazebo launch
     robot_gazebo_launch = IncludeLaunchDescription(
@@ -155,8 +157,9 @@ def generate_launch_description():
                     ]
         ),
 		robot_gazebo_launch,
-        # TimerAction(
-        #     period=4.0,
-        #     actions=[octomap_server_node]
-        # ),
+        TimerAction(
+            period=4.0,
+            actions=[octomap_server_node],
+            condition=IfCondition(octomap)
+        ),
     ])
@@ -1,10 +1,23 @@
 #include "base/BaseNode.h"
 
+#include <cerrno>
+#include <ctime>
+
 sim_bringup::BaseNode::BaseNode(const std::string &node_name, const std::string &config_file_path) : 
     Node(node_name),
     Trajectory(config_file_path),
-    Planner(config_file_path)
+    Planner(config_file_path),
+    jitter_histogram(10, 100),
+    overrun_histogram(1000, 100)
 {
+    rt_loop = false;
+    rt_priority = 0;
+    rt_cpu = -1;
+    rt_lock_memory = false;
+    rt_running = false;
+    rt_handoff = false;
+    num_skipped_periods = 0;
+
     project_abs_path = std::string(__FILE__);
     for (size_t i = 0; i < 4; i++)
         project_abs_path = project_abs_path.substr(0, project_abs_path.find_last_of("/\\"));
@@ -15,15 +28,75 @@ sim_bringup::BaseNode::BaseNode(const std::string &node_name, const std::string
 
         Trajectory::publisher = this->create_publisher<trajectory_msgs::msg::JointTrajectory>
             ("/xarm6_traj_controller/joint_trajectory", 10);
+        Robot::clock = this->get_clock();
+        if (Trajectory::getStreamingChunk() > 0)
+            streaming_timer = this->create_wall_timer(std::chrono::microseconds(size_t(Trajectory::getStreamingChunk() / 4 * 1e6)), 
+                                                      std::bind(&Trajectory::streamingCallback, this));   // Guarded by its own mutex
         
         Robot::joints_state_subscription = this->create_subscription<control_msgs::msg::JointTrajectoryControllerState>
-            ("/xarm6_traj_controller/state", 10, std::bind(&Robot::jointsStateCallback, this, std::placeholders::_1));
+            ("/xarm6_traj_controller/state", 10, synchronized(this, &Robot::jointsStateCallback));
         Robot::gripper_node = std::make_shared<rclcpp::Node>("gripper_node");
         Robot::gripper_client = rclcpp_action::create_client<control_msgs::action::GripperCommand>
             (gripper_node, "/xarm_gripper/gripper_action");
 
+        // Octomap updates are applied to a persistent tree, which is plugged into the state space by 'updateOctree'
+        YAML::Node octomap_node { node["octomap"] };
+        if (octomap_node.IsDefined() && octomap_node["streaming"].IsDefined() && octomap_node["streaming"].as<bool>())
+        {
+            octomap = std::make_shared<sim_bringup::Octomap>(config_file_path);
+            // A received octomap is deserialised within the executor, and only the resulting tree is handed off
+            std::function<void(std::shared_ptr<octomap::OcTree>)> octree_callback { synchronized(octomap.get(), &Octomap::octreeCallback) };
+            octomap->octomap_subscription = this->create_subscription<octomap_msgs::msg::Octomap>
+                (octomap->getOctomapTopic(), rclcpp::QoS(1), [octree_callback](const octomap_msgs::msg::Octomap::SharedPtr msg)
+                {
+                    std::shared_ptr<octomap::OcTree> octomap_octree { Octomap::deserialize(*msg) };
+                    if (octomap_octree != nullptr)
+                        octree_callback(octomap_octree);
+                });
+            
+            if (octomap->getVisualizationRate() > 0)    // The octree is read under its own mutex, so it is not synchronized
+            {
+                octomap->marker_array_publisher = this->create_publisher<visualization_msgs::msg::MarkerArray>
+                    (octomap->getVisualizationTopic(), 10);
+                octomap->visualization_timer = this->create_wall_timer(std::chrono::microseconds(size_t(1e6 / octomap->getVisualizationRate())), 
+                                                                       std::bind(&Octomap::visualize, octomap.get()));
+            }
+        }
+
+        YAML::Node logging_node { node["logging"] };
+        if (logging_node.IsDefined() && logging_node["level"].IsDefined())
+        {
+            Logger::setLevel(Logger::toLevel(logging_node["level"].as<std::string>()));
+            if (Logger::getLevel() == LogLevel::Debug)
+                rclcpp::get_logger("rclcpp").set_level(rclcpp::Logger::Level::Debug);
+        }
+
         period = node["period"].as<float>();
-        timer = this->create_wall_timer(std::chrono::microseconds(size_t(period * 1e6)), std::bind(&BaseNode::baseCallback, this));
+        YAML::Node executor_node { node["executor"] };
+        if (executor_node.IsDefined())
+        {
+            std::string mode { executor_node["mode"].IsDefined() ? executor_node["mode"].as<std::string>() : "timer" };
+            if (mode == "RT")
+                rt_loop = true;
+            else if (mode != "timer")
+                throw std::logic_error("Executor mode '" + mode + "' does not exist!");
+
+            if (executor_node["priority"].IsDefined())
+                rt_priority = executor_node["priority"].as<int>();
+            if (executor_node["cpu"].IsDefined())
+                rt_cpu = executor_node["cpu"].as<int>();
+            if (executor_node["lock_memory"].IsDefined())
+                rt_lock_memory = executor_node["lock_memory"].as<bool>();
+        }
+
+        if (rt_loop)    // The loop is started once the executor is spinning, i.e., when the derived node is completely constructed
+            timer = this->create_wall_timer(1ms, [this]() 
+            {
+                timer->cancel();
+                startRealTimeLoop();
+            });
+        else
+            timer = this->create_wall_timer(std::chrono::microseconds(size_t(period * 1e6)), std::bind(&BaseNode::baseCallback, this));
 
         std::shared_ptr<env::Environment> env { nullptr };
         if (node["environment"].IsDefined())
@@ -31,14 +104,8 @@ sim_bringup::BaseNode::BaseNode(const std::string &node_name, const std::string
         else
             RCLCPP_WARN(rclcpp::get_logger("rclcpp"), "Predefined environment is not set up! Be careful since table is not added to the scene!");
                 
-        std::shared_ptr<base::StateSpace> ss { nullptr };
-        std::string state_space = node["robot"]["space"].as<std::string>();
-        if (state_space == "RealVectorSpace")
-            ss = std::make_shared<base::RealVectorSpace>(Robot::getNumDOFs(), Robot::getRobot(), env);
-        else if (state_space == "RealVectorSpaceFCL")
-            ss = std::make_shared<base::RealVectorSpaceFCL>(Robot::getNumDOFs(), Robot::getRobot(), env);
-        else
-            throw std::logic_error("State space does not exist!");
+        state_space = node["robot"]["space"].as<std::string>();
+        std::shared_ptr<base::StateSpace> ss { createStateSpace(Robot::getRobot(), env) };
 
         YAML::Node q_start_node { node["robot"]["q_start"] };
         YAML::Node q_goal_node { node["robot"]["q_goal"] };
@@ -67,6 +134,13 @@ sim_bringup::BaseNode::BaseNode(const std::string &node_name, const std::string
         }
         
         Planner::scenario = std::make_shared<scenario::Scenario>(ss, q_start, q_goal);
+        Planner::initRoadmap();     // The environment contains only static objects at this point
+
+        // Planners running in parallel share the environment, but each of them needs its own robot instance
+        Planner::state_space_factory = [this]() 
+        {
+            return createStateSpace(Robot::createRobot(), Planner::scenario->getEnvironment());
+        };
     }
     catch (std::exception &e)
     {
@@ -74,4 +148,149 @@ sim_bringup::BaseNode::BaseNode(const std::string &node_name, const std::string
     }
 }
 
-sim_bringup::BaseNode::~BaseNode() {}
\ No newline at end of file
+sim_bringup::BaseNode::~BaseNode() 
+{
+    stopRealTimeLoop();
+}
+
+/// @brief Create a state space of the type specified in the configuration file.
+/// @param robot Robot instance used by the state space.
+/// @param env Environment used by the state space.
+std::shared_ptr<base::StateSpace> sim_bringup::BaseNode::createStateSpace(const std::shared_ptr<robots::AbstractRobot> &robot, 
+    const std::shared_ptr<env::Environment> &env) const
+{
+    if (state_space == "RealVectorSpace")
+        return std::make_shared<base::RealVectorSpace>(Robot::getNumDOFs(), robot, env);
+    else if (state_space == "RealVectorSpaceFCL")
+        return std::make_shared<base::RealVectorSpaceFCL>(Robot::getNumDOFs(), robot, env);
+    else if (state_space == "RealVectorSpaceOctree")
+        return std::make_shared<sim_bringup::RealVectorSpaceOctree>(Robot::getNumDOFs(), robot, env);
+    
+    throw std::logic_error("State space does not exist!");
+}
+
+// Plug the latest octree into the state space (if octomap is streamed, and the state space supports it).
+// An update which was postponed due to a concurrent visualization is applied before.
+void sim_bringup::BaseNode::updateOctree()
+{
+    if (octomap == nullptr)
+        return;
+    
+    octomap->applyPendingUpdate();
+    if (octomap->getOctree() == nullptr)
+        return;
+
+    std::shared_ptr<sim_bringup::RealVectorSpaceOctree> ss
+        { std::dynamic_pointer_cast<sim_bringup::RealVectorSpaceOctree>(Planner::scenario->getStateSpace()) };
+    if (ss != nullptr)
+        ss->setOctree(octomap->getOctree());
+}
+
+sim_bringup::Histogram sim_bringup::BaseNode::getJitterHistogram() const
+{
+    std::lock_guard<std::mutex> lock(statistics_mutex);
+    return jitter_histogram;
+}
+
+sim_bringup::Histogram sim_bringup::BaseNode::getOverrunHistogram() const
+{
+    std::lock_guard<std::mutex> lock(statistics_mutex);
+    return overrun_histogram;
+}
+
+void sim_bringup::BaseNode::startRealTimeLoop()
+{
+    if (rt_running)
+        return;
+
+    if (rt_lock_memory)
+        lockMemory();
+    
+    {
+        std::lock_guard<std::mutex> lock(statistics_mutex);
+        jitter_histogram.clear();
+        overrun_histogram.clear();
+    }
+    num_skipped_periods = 0;
+    {
+        std::lock_guard<std::mutex> lock(handoff_mutex);
+        pending_callbacks.reserve(64);      // Buffers keep their capacity, so they are usually not reallocated later
+        running_callbacks.reserve(64);
+        rt_handoff = true;
+    }
+    rt_running = true;
+    rt_thread = std::thread(&BaseNode::realTimeLoop, this);
+    RCLCPP_INFO(rclcpp::get_logger("rclcpp"), "Real-time loop is started with period %f [ms] (priority: %d, CPU: %d).", 
+        period * 1e3, rt_priority, rt_cpu);
+}
+
+/// @brief Stop the real-time loop (after the current iteration), and report its jitter and overrun statistics.
+void sim_bringup::BaseNode::stopRealTimeLoop()
+{
+    if (!rt_running.exchange(false))
+        return;
+
+    if (rt_thread.joinable())
+        rt_thread.join();
+
+    RCLCPP_INFO(rclcpp::get_logger("rclcpp"), "Real-time loop is stopped. Skipped periods: %ld", num_skipped_periods.load());
+    RCLCPP_INFO(rclcpp::get_logger("rclcpp"), "Wake-up jitter: %s", getJitterHistogram().toString("[us]").c_str());
+    RCLCPP_INFO(rclcpp::get_logger("rclcpp"), "Iteration overrun: %s", getOverrunHistogram().toString("[us]").c_str());
+}
+
+// Call 'baseCallback' periodically. The thread sleeps until absolute deadlines, so the period does not drift 
+// due to the iteration runtime. If an iteration overruns whole periods, the missed deadlines are skipped instead of 
+// running the iterations back-to-back. Callbacks handed off by 'synchronized' are run before each iteration.
+void sim_bringup::BaseNode::realTimeLoop()
+{
+    setThreadAffinity(pthread_self(), rt_cpu);
+    setThreadPriority(pthread_self(), rt_priority);
+
+    const int64_t period_ns { int64_t(period * 1e9) };
+    auto toNanoseconds = [](const timespec &t) -> int64_t { return int64_t(t.tv_sec) * 1000000000 + t.tv_nsec; };
+    timespec now {};
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    int64_t deadline_ns { toNanoseconds(now) };
+
+    while (rt_running.load(std::memory_order_acquire) && rclcpp::ok())
+    {
+        deadline_ns += period_ns;
+        timespec deadline { time_t(deadline_ns / 1000000000), long(deadline_ns % 1000000000) };
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, nullptr) == EINTR) {}
+        
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        const float jitter { (toNanoseconds(now) - deadline_ns) * 1e-3f };
+        if (!rt_running.load(std::memory_order_acquire))
+            break;
+
+        {
+            std::lock_guard<std::mutex> lock(handoff_mutex);
+            running_callbacks.swap(pending_callbacks);
+        }
+        for (std::function<void()> &callback : running_callbacks)
+            callback();
+        
+        running_callbacks.clear();
+        baseCallback();
+
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        int64_t overrun_ns { toNanoseconds(now) - (deadline_ns + period_ns) };
+        {
+            std::lock_guard<std::mutex> lock(statistics_mutex);
+            jitter_histogram.add(jitter);
+            overrun_histogram.add(overrun_ns * 1e-3);
+        }
+        if (overrun_ns > 0)
+        {
+            FAST_LOG_WARN("Real-time loop overrun by %f [ms].", overrun_ns * 1e-6);
+            int64_t num_missed { overrun_ns / period_ns };
+            num_skipped_periods.fetch_add(num_missed, std::memory_order_relaxed);
+            deadline_ns += num_missed * period_ns;
+        }
+    }
+
+    // Callbacks are called right away from now on, while the ones which are still pending are dropped
+    std::lock_guard<std::mutex> lock(handoff_mutex);
+    pending_callbacks.clear();
+    rt_handoff = false;
+}
\ No newline at end of file
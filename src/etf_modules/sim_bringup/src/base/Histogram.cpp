@@ -0,0 +1,71 @@
+#include "base/Histogram.h"
+
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+
+sim_bringup::Histogram::Histogram(float bin_width_, size_t num_bins)
+{
+    bin_width = bin_width_;
+    bins = std::vector<size_t>(std::max(num_bins, size_t(1)), 0);
+    clear();
+}
+
+void sim_bringup::Histogram::add(float value)
+{
+    value = std::max(value, 0.0f);
+    size_t idx { std::min(size_t(value / bin_width), bins.size() - 1) };
+    bins[idx]++;
+    num_samples++;
+    sum += value;
+    max = std::max(max, value);
+}
+
+void sim_bringup::Histogram::clear()
+{
+    std::fill(bins.begin(), bins.end(), 0);
+    num_samples = 0;
+    sum = 0;
+    max = 0;
+}
+
+/// @brief Get an upper bound of the 'p'-th percentile, i.e., the upper edge of the bin where it lies.
+/// @param p Percentile in the range [0, 100].
+/// @return The percentile. If it lies in the last bin, the maximal value is returned.
+float sim_bringup::Histogram::getPercentile(float p) const
+{
+    if (num_samples == 0)
+        return 0;
+
+    size_t count { 0 };
+    size_t threshold { std::max(size_t(std::ceil(std::clamp(p, 0.0f, 100.0f) / 100 * num_samples)), size_t(1)) };
+    for (size_t i = 0; i < bins.size() - 1; i++)
+    {
+        count += bins[i];
+        if (count >= threshold)
+            return std::min((i + 1) * bin_width, max);
+    }
+
+    return max;
+}
+
+/// @brief Print non-empty bins, one per line, as '[from, to) unit: count'.
+std::string sim_bringup::Histogram::toString(const std::string &unit) const
+{
+    std::ostringstream out;
+    out << "samples: " << num_samples << ", mean: " << getMean() << " " << unit << ", p99: " << getPercentile(99)
+        << " " << unit << ", max: " << max << " " << unit << "\n";
+
+    for (size_t i = 0; i < bins.size(); i++)
+    {
+        if (bins[i] == 0)
+            continue;
+
+        if (i < bins.size() - 1)
+            out << "\t [" << i * bin_width << ", " << (i + 1) * bin_width << ") " << unit << ": " << bins[i] << "\n";
+        else
+            out << "\t [" << i * bin_width << ", inf) " << unit << ": " << bins[i] << "\n";
+    }
+
+    return out.str();
+}
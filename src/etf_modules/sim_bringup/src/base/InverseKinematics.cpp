@@ -0,0 +1,172 @@
+#include "base/InverseKinematics.h"
+
+#include <algorithm>
+#include <cmath>
+
+sim_bringup::InverseKinematics::InverseKinematics(const std::function<std::shared_ptr<robots::AbstractRobot>()> &robot_factory,
+    size_t num_threads, size_t num_attempts_, float position_resolution_, float orientation_resolution_)
+{
+    num_threads = std::max(num_threads, size_t(1));
+    for (size_t k = 0; k < num_threads; k++)
+        robots.emplace_back(robot_factory());
+
+    thread_pool = std::make_unique<sim_bringup::ThreadPool>(num_threads);
+    num_attempts = std::max(num_attempts_, size_t(1));
+    position_resolution = position_resolution_;
+    orientation_resolution = orientation_resolution_;
+    num_hits = 0;
+    num_misses = 0;
+}
+
+/// @brief Compute a joint configuration for the TCP pose ('R', 'p').
+/// Cached solutions for this pose, which are accepted and reach the pose within tolerance, are returned without running IK.
+/// Otherwise, attempts run in parallel rounds (one attempt per thread), until a round gives an accepted solution,
+/// or 'num_attempts' is reached. Seeds are taken in the following order: cached solutions for this pose, 'q_ref',
+/// and then random initial configurations.
+/// @param R Orientation of the TCP.
+/// @param p Position of the TCP.
+/// @param q_ref Reference configuration, i.e., the chosen solution is the closest one to it. It can be nullptr.
+/// @param criterion Acceptance criterion for solutions (nullptr - all solutions are accepted).
+/// @return The chosen solution, or nullptr if there is no accepted solution.
+std::shared_ptr<base::State> sim_bringup::InverseKinematics::solve(const KDL::Rotation &R, const KDL::Vector &p,
+    const std::shared_ptr<base::State> &q_ref, const Criterion &criterion)
+{
+    const std::vector<int> key { quantise(R, p) };
+    std::vector<std::shared_ptr<base::State>> seeds {};
+    auto it { solutions.find(key) };
+    if (it != solutions.end())
+    {
+        for (const Eigen::VectorXf &q : it->second)
+            seeds.emplace_back(std::make_shared<base::RealVectorSpaceState>(q));
+
+        std::vector<std::shared_ptr<base::State>> valid {};
+        for (const std::shared_ptr<base::State> &q : seeds)
+        {
+            if ((criterion == nullptr || criterion(q)) && isWithinTolerance(q, R, p))
+                valid.emplace_back(q);
+        }
+
+        if (!valid.empty())
+        {
+            num_hits++;
+            return chooseClosest(valid, q_ref);
+        }
+
+        if (q_ref != nullptr)
+            std::sort(seeds.begin(), seeds.end(), [&q_ref](const std::shared_ptr<base::State> &a, const std::shared_ptr<base::State> &b)
+                { return (a->getCoord() - q_ref->getCoord()).norm() < (b->getCoord() - q_ref->getCoord()).norm(); });
+    }
+    const size_t num_cached_seeds { seeds.size() };
+    if (q_ref != nullptr)
+        seeds.emplace_back(q_ref);
+    while (seeds.size() < num_attempts)
+        seeds.emplace_back(nullptr);
+
+    std::vector<std::shared_ptr<base::State>> accepted {};
+    bool hit { false };
+    for (size_t idx = 0; idx < seeds.size() && accepted.empty(); idx += robots.size())
+    {
+        std::vector<std::future<std::shared_ptr<base::State>>> results {};
+        for (size_t k = 0; k < robots.size() && idx + k < seeds.size(); k++)
+        {
+            results.emplace_back(thread_pool->submit([&, k, seed = seeds[idx + k]]() -> std::shared_ptr<base::State>
+            {
+                std::shared_ptr<base::State> q { robots[k]->computeInverseKinematics(R, p, seed) };
+                if (q == nullptr || (criterion != nullptr && !criterion(q)))
+                    return nullptr;
+
+                return q;
+            }));
+        }
+
+        for (size_t k = 0; k < results.size(); k++)
+        {
+            std::shared_ptr<base::State> q { results[k].get() };
+            if (q == nullptr)
+                continue;
+
+            accepted.emplace_back(q);
+            if (idx + k < num_cached_seeds)
+                hit = true;
+        }
+    }
+
+    if (hit)    // At most one hit per call, regardless of the number of accepted cached seeds
+        num_hits++;
+
+    if (accepted.empty())
+    {
+        num_misses++;
+        return nullptr;
+    }
+
+    for (const std::shared_ptr<base::State> &q : accepted)
+        memorise(key, q);
+
+    return chooseClosest(accepted, q_ref);
+}
+
+void sim_bringup::InverseKinematics::clear()
+{
+    solutions.clear();
+}
+
+std::vector<int> sim_bringup::InverseKinematics::quantise(const KDL::Rotation &R, const KDL::Vector &p) const
+{
+    std::vector<int> key {};
+    for (size_t i = 0; i < 3; i++)
+        key.emplace_back(std::lround(p(i) / position_resolution));
+
+    for (size_t i = 0; i < 3; i++)
+        for (size_t j = 0; j < 3; j++)
+            key.emplace_back(std::lround(R(i, j) / orientation_resolution));
+
+    return key;
+}
+
+// Whether the TCP pose of 'q' (the last frame of its forward kinematics) is within tolerance of ('R', 'p').
+// Must not be called while IK attempts are running, since it uses the robot instance of the first thread.
+bool sim_bringup::InverseKinematics::isWithinTolerance(const std::shared_ptr<base::State> &q, const KDL::Rotation &R, 
+    const KDL::Vector &p) const
+{
+    const std::shared_ptr<std::vector<KDL::Frame>> frames { robots.front()->computeForwardKinematics(q) };
+    const KDL::Frame &tcp { frames->back() };
+    return (tcp.p - p).Norm() <= POSITION_TOLERANCE && KDL::diff(tcp.M, R).Norm() <= ORIENTATION_TOLERANCE;
+}
+
+std::shared_ptr<base::State> sim_bringup::InverseKinematics::chooseClosest(const std::vector<std::shared_ptr<base::State>> &solutions_,
+    const std::shared_ptr<base::State> &q_ref) const
+{
+    if (q_ref == nullptr)
+        return solutions_.front();
+
+    return *std::min_element(solutions_.begin(), solutions_.end(),
+        [&q_ref](const std::shared_ptr<base::State> &a, const std::shared_ptr<base::State> &b)
+        { return (a->getCoord() - q_ref->getCoord()).norm() < (b->getCoord() - q_ref->getCoord()).norm(); });
+}
+
+// Only distinct solutions (e.g., different arm configurations) are kept, and at most a few of them per pose
+void sim_bringup::InverseKinematics::memorise(const std::vector<int> &key, const std::shared_ptr<base::State> &q)
+{
+    const size_t max_num_solutions { 4 };
+    std::vector<Eigen::VectorXf> &solutions_ { solutions[key] };
+    for (const Eigen::VectorXf &q_ : solutions_)
+    {
+        if ((q_ - q->getCoord()).norm() < 0.1)
+            return;
+    }
+
+    if (solutions_.size() >= max_num_solutions)
+        solutions_.erase(solutions_.begin());
+
+    solutions_.emplace_back(q->getCoord());
+}
+
+size_t sim_bringup::InverseKinematics::KeyHash::operator()(const std::vector<int> &key) const
+{
+    size_t hash { 0 };
+    for (int value : key)
+        hash = hash * 31 + std::hash<int>{}(value);
+
+    return hash;
+}
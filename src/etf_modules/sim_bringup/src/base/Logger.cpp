@@ -0,0 +1,231 @@
+#include "base/Logger.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+
+sim_bringup::Logger::Logger()
+{
+    buffer = std::make_unique<Cell[]>(BUFFER_SIZE);
+    for (size_t i = 0; i < BUFFER_SIZE; i++)
+        buffer[i].sequence.store(i, std::memory_order_relaxed);
+    
+    enqueue_pos.store(0, std::memory_order_relaxed);
+    dequeue_pos.store(0, std::memory_order_relaxed);
+    num_dropped.store(0, std::memory_order_relaxed);
+    running.store(true, std::memory_order_relaxed);
+    thread = std::thread(&Logger::run, this);
+}
+
+sim_bringup::Logger::~Logger()
+{
+    running.store(false, std::memory_order_release);
+    if (thread.joinable())
+        thread.join();
+}
+
+sim_bringup::Logger &sim_bringup::Logger::getInstance()
+{
+    static Logger logger {};
+    return logger;
+}
+
+sim_bringup::LogLevel sim_bringup::Logger::toLevel(const std::string &level_str)
+{
+    if (level_str == "DEBUG")
+        return LogLevel::Debug;
+    else if (level_str == "INFO")
+        return LogLevel::Info;
+    else if (level_str == "WARN")
+        return LogLevel::Warn;
+    else if (level_str == "ERROR")
+        return LogLevel::Error;
+    else if (level_str == "NONE")
+        return LogLevel::None;
+    
+    throw std::logic_error("Logging level '" + level_str + "' does not exist!");
+}
+
+// Wait until all records stored so far are printed
+void sim_bringup::Logger::flush()
+{
+    size_t pos { enqueue_pos.load(std::memory_order_acquire) };
+    while (dequeue_pos.load(std::memory_order_acquire) < pos && running.load(std::memory_order_acquire))
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+}
+
+// Bounded multi-producer queue: each cell carries a sequence number telling whether it is free for 
+// the producer at position 'pos' (sequence == pos) or ready for the consumer (sequence == pos + 1).
+bool sim_bringup::Logger::push(const Record &record)
+{
+    size_t pos { enqueue_pos.load(std::memory_order_relaxed) };
+    Cell *cell { nullptr };
+    while (true)
+    {
+        cell = &buffer[pos & (BUFFER_SIZE - 1)];
+        size_t sequence { cell->sequence.load(std::memory_order_acquire) };
+        intptr_t diff { intptr_t(sequence) - intptr_t(pos) };
+        if (diff == 0)
+        {
+            if (enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                break;
+        }
+        else if (diff < 0)     // The buffer is full
+        {
+            num_dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        else
+            pos = enqueue_pos.load(std::memory_order_relaxed);
+    }
+    
+    cell->record = record;
+    cell->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+// Only the background thread consumes records
+bool sim_bringup::Logger::pop(Record &record)
+{
+    size_t pos { dequeue_pos.load(std::memory_order_relaxed) };
+    Cell *cell { &buffer[pos & (BUFFER_SIZE - 1)] };
+    if (cell->sequence.load(std::memory_order_acquire) != pos + 1)
+        return false;
+    
+    record = cell->record;
+    cell->sequence.store(pos + BUFFER_SIZE, std::memory_order_release);
+    dequeue_pos.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+// Producers never notify the background thread (it would cost a system call in a hot loop). Instead, the thread polls 
+// the buffer, and its sleep is doubled (up to MAX_IDLE_SLEEP) while the buffer stays empty, so an idle logger rarely wakes up.
+void sim_bringup::Logger::run()
+{
+    Record record {};
+    size_t num_dropped_reported { 0 };
+    std::chrono::milliseconds idle_sleep { 1 };
+    while (true)
+    {
+        bool popped { false };
+        while (pop(record))
+        {
+            print(record);
+            popped = true;
+        }
+
+        size_t num_dropped_ { num_dropped.load(std::memory_order_relaxed) };
+        if (num_dropped_ > num_dropped_reported)
+        {
+            RCLCPP_WARN(rclcpp::get_logger("rclcpp"), "Logging buffer is full. %ld records are dropped so far.", num_dropped_);
+            num_dropped_reported = num_dropped_;
+        }
+
+        if (popped)
+            idle_sleep = std::chrono::milliseconds(1);
+        else
+        {
+            if (!running.load(std::memory_order_acquire))
+                break;
+            std::this_thread::sleep_for(idle_sleep);
+            idle_sleep = std::min(2 * idle_sleep, MAX_IDLE_SLEEP);
+        }
+    }
+}
+
+/// @brief Format 'record' by walking through its format, and formatting each conversion separately 
+/// with the stored argument. Length modifiers are replaced, since arguments are stored as 64-bit values.
+std::string sim_bringup::Logger::toString(const Record &record)
+{
+    std::string str {};
+    str.reserve(128);
+    char spec[32] {};
+    char buf[64] {};
+    size_t arg_idx { 0 };
+    
+    for (const char *c = record.format; *c != '\0'; c++)
+    {
+        if (*c != '%')
+        {
+            str += *c;
+            continue;
+        }
+        if (*(c+1) == '%')
+        {
+            str += '%';
+            c++;
+            continue;
+        }
+
+        // Flags, width and precision are copied, while length modifiers are skipped
+        size_t len { 0 };
+        spec[len++] = '%';
+        c++;
+        while (*c != '\0' && std::strchr("-+ #0123456789.", *c) != nullptr && len < sizeof(spec) - 4)
+            spec[len++] = *c++;
+        while (*c != '\0' && std::strchr("hlLqjzt", *c) != nullptr)
+            c++;
+        if (*c == '\0')
+            break;
+
+        if (arg_idx >= record.num_args || std::strchr("diouxXcfFeEgGaA", *c) == nullptr)
+        {
+            str += '?';
+            continue;
+        }
+
+        const Arg &arg { record.args[arg_idx] };
+        const ArgType type { record.types[arg_idx++] };
+        if (std::strchr("fFeEgGaA", *c) != nullptr)
+        {
+            spec[len++] = *c;
+            spec[len] = '\0';
+            double value { type == ArgType::Float ? arg.f : (type == ArgType::Int ? double(arg.i) : double(arg.u)) };
+            std::snprintf(buf, sizeof(buf), spec, value);
+        }
+        else if (*c == 'c')
+        {
+            spec[len++] = *c;
+            spec[len] = '\0';
+            std::snprintf(buf, sizeof(buf), spec, int(type == ArgType::Float ? int64_t(arg.f) : arg.i));
+        }
+        else
+        {
+            spec[len++] = 'l';
+            spec[len++] = 'l';
+            spec[len++] = *c;
+            spec[len] = '\0';
+            if (*c == 'd' || *c == 'i')
+                std::snprintf(buf, sizeof(buf), spec, (long long) (type == ArgType::Float ? int64_t(arg.f) : arg.i));
+            else
+                std::snprintf(buf, sizeof(buf), spec, (unsigned long long) (type == ArgType::Float ? uint64_t(arg.f) : arg.u));
+        }
+        str += buf;
+    }
+
+    return str;
+}
+
+void sim_bringup::Logger::print(const Record &record)
+{
+    std::string str { toString(record) };
+    double time { record.time * 1e-9 };
+    switch (record.level)
+    {
+    case LogLevel::Debug:
+        RCLCPP_DEBUG(rclcpp::get_logger("rclcpp"), "[%.6f] %s", time, str.c_str());
+        break;
+    case LogLevel::Info:
+        RCLCPP_INFO(rclcpp::get_logger("rclcpp"), "[%.6f] %s", time, str.c_str());
+        break;
+    case LogLevel::Warn:
+        RCLCPP_WARN(rclcpp::get_logger("rclcpp"), "[%.6f] %s", time, str.c_str());
+        break;
+    case LogLevel::Error:
+        RCLCPP_ERROR(rclcpp::get_logger("rclcpp"), "[%.6f] %s", time, str.c_str());
+        break;
+    default:
+        break;
+    }
+}
@@ -0,0 +1,207 @@
+#include "base/PathCache.h"
+
+#include <rclcpp/rclcpp.hpp>
+#include <yaml-cpp/yaml.h>
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <functional>
+
+sim_bringup::PathCache::PathCache(float resolution_, size_t capacity_)
+{
+    resolution = resolution_;
+    capacity = std::max(capacity_, size_t(1));
+    num_hits = 0;
+    num_misses = 0;
+}
+
+/// @brief Find a cached path for the given problem.
+/// @return Pointer to the cached path (valid until the cache is modified), or nullptr if there is no such path.
+/// @note The path is not validated here. Its first and last state are only within 'resolution' from 'q_start' and 'q_goal'.
+const std::vector<Eigen::VectorXf> *sim_bringup::PathCache::find(const Eigen::VectorXf &q_start, const Eigen::VectorXf &q_goal,
+                                                                  size_t env_hash)
+{
+    auto it { entries.find(computeKey(q_start, q_goal, env_hash)) };
+    if (it == entries.end())
+    {
+        num_misses++;
+        return nullptr;
+    }
+
+    num_hits++;
+    paths.splice(paths.begin(), paths, it->second);
+    return &it->second->path;
+}
+
+void sim_bringup::PathCache::insert(const Eigen::VectorXf &q_start, const Eigen::VectorXf &q_goal, size_t env_hash,
+                                    const std::vector<Eigen::VectorXf> &path)
+{
+    insert(computeKey(q_start, q_goal, env_hash), path);
+}
+
+void sim_bringup::PathCache::insert(Key &&key, const std::vector<Eigen::VectorXf> &path)
+{
+    auto it { entries.find(key) };
+    if (it != entries.end())
+    {
+        it->second->path = path;
+        paths.splice(paths.begin(), paths, it->second);
+        return;
+    }
+
+    if (paths.size() >= capacity)
+    {
+        entries.erase(paths.back().key);
+        paths.pop_back();
+    }
+
+    paths.emplace_front(Entry { std::move(key), path });
+    entries.emplace(paths.front().key, paths.begin());
+}
+
+void sim_bringup::PathCache::clear()
+{
+    paths.clear();
+    entries.clear();
+}
+
+/// @brief Save all cached paths to a yaml file 'file_path' (from the most to the least recently used).
+bool sim_bringup::PathCache::save(const std::string &file_path) const
+{
+    YAML::Node node {};
+    node["resolution"] = resolution;
+    for (const Entry &entry : paths)
+    {
+        YAML::Node entry_node {};
+        for (int coord : entry.key.start)
+            entry_node["start"].push_back(coord);
+        for (int coord : entry.key.goal)
+            entry_node["goal"].push_back(coord);
+        entry_node["env_hash"] = std::to_string(entry.key.env_hash);
+        for (const Eigen::VectorXf &q : entry.path)
+        {
+            YAML::Node q_node {};
+            for (long k = 0; k < q.size(); k++)
+                q_node.push_back(q(k));
+            q_node.SetStyle(YAML::EmitterStyle::Flow);
+            entry_node["path"].push_back(q_node);
+        }
+        entry_node["start"].SetStyle(YAML::EmitterStyle::Flow);
+        entry_node["goal"].SetStyle(YAML::EmitterStyle::Flow);
+        node["paths"].push_back(entry_node);
+    }
+
+    std::ofstream file_out(file_path, std::ofstream::out);
+    if (!file_out.is_open())
+    {
+        RCLCPP_WARN(rclcpp::get_logger("rclcpp"), "Path cache cannot be saved to %s", file_path.c_str());
+        return false;
+    }
+
+    file_out << node;
+    return true;
+}
+
+/// @brief Load cached paths from a yaml file 'file_path' (previously created by 'save').
+/// Paths cached with a different resolution are discarded, since their keys do not match.
+/// @return Whether the file is loaded.
+bool sim_bringup::PathCache::load(const std::string &file_path)
+{
+    YAML::Node node {};
+    try
+    {
+        node = YAML::LoadFile(file_path);
+    }
+    catch (std::exception &e)
+    {
+        RCLCPP_INFO(rclcpp::get_logger("rclcpp"), "Path cache is not loaded from %s", file_path.c_str());
+        return false;
+    }
+
+    if (!node["resolution"].IsDefined() || std::abs(node["resolution"].as<float>() - resolution) > 1e-6)
+    {
+        RCLCPP_WARN(rclcpp::get_logger("rclcpp"), "Path cache in %s has a different resolution! It is discarded.", file_path.c_str());
+        return false;
+    }
+
+    // Entries are inserted from the least recently used, so the order of usage is preserved
+    YAML::Node paths_node { node["paths"] };
+    for (size_t i = paths_node.size(); i-- > 0; )
+    {
+        YAML::Node entry_node { paths_node[i] };
+        Key key {};
+        for (size_t k = 0; k < entry_node["start"].size(); k++)
+            key.start.emplace_back(entry_node["start"][k].as<int>());
+        for (size_t k = 0; k < entry_node["goal"].size(); k++)
+            key.goal.emplace_back(entry_node["goal"][k].as<int>());
+        key.env_hash = std::stoull(entry_node["env_hash"].as<std::string>());
+
+        std::vector<Eigen::VectorXf> path {};
+        for (size_t j = 0; j < entry_node["path"].size(); j++)
+        {
+            YAML::Node q_node { entry_node["path"][j] };
+            Eigen::VectorXf q(q_node.size());
+            for (size_t k = 0; k < q_node.size(); k++)
+                q(k) = q_node[k].as<float>();
+            path.emplace_back(q);
+        }
+        insert(std::move(key), path);
+    }
+
+    RCLCPP_INFO(rclcpp::get_logger("rclcpp"), "Loaded %ld cached paths from %s", paths.size(), file_path.c_str());
+    return true;
+}
+
+/// @brief Compute a hash of all objects in 'env', except dynamic obstacles (which change all the time).
+/// Positions and dimensions are quantised to 1 [mm], so a numerically identical scene always gives the same hash.
+size_t sim_bringup::PathCache::computeEnvironmentHash(const std::shared_ptr<env::Environment> &env)
+{
+    size_t hash { 0 };
+    auto combine = [&hash](size_t value) { hash ^= value + 0x9e3779b9 + (hash << 6) + (hash >> 2); };
+    for (size_t i = 0; i < env->getNumObjects(); i++)
+    {
+        const std::shared_ptr<env::Object> &object { env->getObject(i) };
+        if (object->getLabel() == "dynamic_obstacle")
+            continue;
+
+        combine(std::hash<std::string>{}(object->getLabel()));
+        for (size_t k = 0; k < 3; k++)
+        {
+            combine(std::hash<long>{}(std::lround(object->getPosition()(k) * 1e3)));
+            combine(std::hash<long>{}(std::lround(object->getDimensions()(k) * 1e3)));
+        }
+    }
+
+    return hash;
+}
+
+sim_bringup::PathCache::Key sim_bringup::PathCache::computeKey(const Eigen::VectorXf &q_start, const Eigen::VectorXf &q_goal,
+                                                               size_t env_hash) const
+{
+    return Key { quantise(q_start), quantise(q_goal), env_hash };
+}
+
+std::vector<int> sim_bringup::PathCache::quantise(const Eigen::VectorXf &q) const
+{
+    std::vector<int> q_quantised(q.size());
+    for (long k = 0; k < q.size(); k++)
+        q_quantised[k] = std::lround(q(k) / resolution);
+
+    return q_quantised;
+}
+
+bool sim_bringup::PathCache::Key::operator==(const Key &other) const
+{
+    return env_hash == other.env_hash && start == other.start && goal == other.goal;
+}
+
+size_t sim_bringup::PathCache::KeyHash::operator()(const Key &key) const
+{
+    size_t hash { key.env_hash };
+    for (int coord : key.start)
+        hash = hash * 31 + std::hash<int>{}(coord);
+    for (int coord : key.goal)
+        hash = hash * 31 + std::hash<int>{}(coord);
+
+    return hash;
+}
@@ -1,4 +1,9 @@
 #include "base/Planner.h"
+#include "state_spaces/RealVectorSpaceOctree.h"
+
+#include <algorithm>
+#include <chrono>
+#include <random>
 
 sim_bringup::Planner::Planner(const std::string &config_file_path)
 {
@@ -6,6 +11,7 @@ sim_bringup::Planner::Planner(const std::string &config_file_path)
     for (size_t i = 0; i < 4; i++)
         project_abs_path = project_abs_path.substr(0, project_abs_path.find_last_of("/\\"));
 
+    planning_time = 0;
     try
     {
         YAML::Node node { YAML::LoadFile(project_abs_path + config_file_path) };
@@ -16,28 +22,21 @@ sim_bringup::Planner::Planner(const std::string &config_file_path)
             return;
         }
         
-        ConfigurationReader::initConfiguration(project_abs_path + planner_node["configurations"].as<std::string>());
+        StaticPlannerConfig::initConfiguration(project_abs_path + planner_node["configurations"].as<std::string>());
         planner = nullptr;
+        config = PlannerConfig::load(planner_node);
 
-        std::string type { planner_node["type"].as<std::string>() };
-        if (type == "RGBMT*")
-            planner_type = planning::PlannerType::RGBMTStar;
-        else if (type == "RGBT-Connect")
-            planner_type = planning::PlannerType::RGBTConnect;
-        else if (type == "RBT-Connect")
-            planner_type = planning::PlannerType::RBTConnect;
-        else if (type == "RRT-Connect")
-            planner_type = planning::PlannerType::RRTConnect;
-
-        YAML::Node max_planning_time_node { planner_node["max_planning_time"] };
-        max_planning_time = (max_planning_time_node.IsDefined()) ? max_planning_time_node.as<float>() : INFINITY;
-
-        if (planner_node["max_edge_length"].IsDefined())
-            max_edge_length = planner_node["max_edge_length"].as<float>();
-        else
+        if (config.use_roadmap && !config.roadmap_file.empty())
+            roadmap_file = project_abs_path + config.roadmap_file;
+
+        if (config.use_path_cache)
         {
-            max_edge_length = 0.1;
-            RCLCPP_WARN(rclcpp::get_logger("rclcpp"), "Maximal edge length is not defined! Using default value of %f", max_edge_length);
+            path_cache = std::make_unique<sim_bringup::PathCache>(config.path_cache_resolution, config.path_cache_capacity);
+            if (!config.path_cache_file.empty())
+            {
+                path_cache_file = project_abs_path + config.path_cache_file;
+                path_cache->load(path_cache_file);
+            }
         }
     }
     catch (std::exception &e)
@@ -48,6 +47,39 @@ sim_bringup::Planner::Planner(const std::string &config_file_path)
     ready = true;
 }
 
+sim_bringup::Planner::~Planner()
+{
+    if (path_cache == nullptr)
+        return;
+
+    RCLCPP_INFO(rclcpp::get_logger("rclcpp"), "Path cache: %ld hits, %ld misses, %ld paths.", 
+        path_cache->getNumHits(), path_cache->getNumMisses(), path_cache->size());
+    if (!path_cache_file.empty())
+        path_cache->save(path_cache_file);
+}
+
+std::unique_ptr<planning::AbstractPlanner> sim_bringup::Planner::createPlanner(planning::PlannerType type, 
+    const std::shared_ptr<base::StateSpace> &ss, const std::shared_ptr<base::State> &q_start, const std::shared_ptr<base::State> &q_goal)
+{
+    switch (type)
+    {
+    case planning::PlannerType::RGBMTStar:
+        return std::make_unique<planning::rbt_star::RGBMTStar>(ss, q_start, q_goal);
+
+    case planning::PlannerType::RGBTConnect:
+        return std::make_unique<planning::rbt::RGBTConnect>(ss, q_start, q_goal);
+    
+    case planning::PlannerType::RBTConnect:
+        return std::make_unique<planning::rbt::RBTConnect>(ss, q_start, q_goal);
+
+    case planning::PlannerType::RRTConnect:
+        return std::make_unique<planning::rrt::RRTConnect>(ss, q_start, q_goal);
+
+    default:
+        throw std::domain_error("The requested static planner is not found! ");
+    }
+}
+
 /// @brief Solve a path planning problem from a start configuration 'q_start' to a goal configuration 'q_goal'
 /// within a specified time limit 'max_planning_time_'.
 /// @param q_start Start configuration
@@ -70,8 +102,8 @@ bool sim_bringup::Planner::solve(std::shared_ptr<base::State> q_start, std::shar
     else
         scenario->setGoal(q_goal);
 
-    if (max_planning_time_ != -1)
-        max_planning_time = max_planning_time_;
+    if (max_planning_time_ == -1)
+        max_planning_time_ = config.max_planning_time;
     
     RCLCPP_INFO(rclcpp::get_logger("rclcpp"), "Planning the path..."); 
     RCLCPP_INFO(rclcpp::get_logger("rclcpp"), "\t Number of collision objects: %ld", scenario->getEnvironment()->getNumObjects());
@@ -90,42 +122,63 @@ bool sim_bringup::Planner::solve(std::shared_ptr<base::State> q_start, std::shar
 
     try
     {
-        switch (planner_type)
+        std::chrono::steady_clock::time_point time_start { std::chrono::steady_clock::now() };
+        bool repaired { false };
+        bool cached { false };
+        size_t env_hash { 0 };
+        if (path_cache != nullptr)
         {
-        case planning::PlannerType::RGBMTStar:
-            RGBMTStarConfig::MAX_PLANNING_TIME = max_planning_time;
-            planner = std::make_unique<planning::rbt_star::RGBMTStar>(scenario->getStateSpace(), q_start, q_goal);
-            break;
+            env_hash = PathCache::computeEnvironmentHash(scenario->getEnvironment());
+            cached = findCachedPath(q_start, q_goal, env_hash);
+            if (cached)
+                RCLCPP_INFO(rclcpp::get_logger("rclcpp"), "\t The cached path is still valid.");
+        }
 
-        case planning::PlannerType::RGBTConnect:
-            RGBTConnectConfig::MAX_PLANNING_TIME = max_planning_time;
-            planner = std::make_unique<planning::rbt::RGBTConnect>(scenario->getStateSpace(), q_start, q_goal);
-            break;
+        if (!cached && config.warm_start)
+        {
+            repaired = repairPath(q_start, q_goal, max_planning_time_);
+            if (repaired)
+                RCLCPP_INFO(rclcpp::get_logger("rclcpp"), "\t The previous path is repaired (warm start).");
+        }
         
-        case planning::PlannerType::RBTConnect:
-            RBTConnectConfig::MAX_PLANNING_TIME = max_planning_time;
-            planner = std::make_unique<planning::rbt::RBTConnect>(scenario->getStateSpace(), q_start, q_goal);
-            break;
-
-        case planning::PlannerType::RRTConnect:
-            RRTConnectConfig::MAX_PLANNING_TIME = max_planning_time;
-            planner = std::make_unique<planning::rrt::RRTConnect>(scenario->getStateSpace(), q_start, q_goal);
-            break;
+        if (cached || repaired)
+            result = true;
+        else
+        {
+            float time_elapsed { std::chrono::duration<float>(std::chrono::steady_clock::now() - time_start).count() };
+            std::vector<std::shared_ptr<base::State>> new_path {};
+            result = solveFromScratch(q_start, q_goal, max_planning_time_ - time_elapsed, new_path);
+            if (result)
+                path = std::move(new_path);
+        }
+        planning_time = std::chrono::duration<float>(std::chrono::steady_clock::now() - time_start).count();
 
-        default:
-            throw std::domain_error("The requested static planner is not found! ");
+        // Cached paths are stored after post-processing
+        if (result && !cached && (config.shortcutting_time > 0 || config.smoothing_iterations > 0))
+        {
+            time_start = std::chrono::steady_clock::now();
+            const float cost { computePathCost(path) };
+            shortcutPath(path, config.shortcutting_time);
+            smoothPath(path, config.smoothing_iterations);
+            RCLCPP_INFO(rclcpp::get_logger("rclcpp"), "\t Path is post-processed in %f [ms]. Path cost: %f -> %f", 
+                std::chrono::duration<float>(std::chrono::steady_clock::now() - time_start).count() * 1e3, cost, computePathCost(path));
         }
 
-        result = planner->solve();
+        if (result && !cached && path_cache != nullptr)
+        {
+            std::vector<Eigen::VectorXf> path_coords {};
+            for (const std::shared_ptr<base::State> &q : path)
+                path_coords.emplace_back(q->getCoord());
+            path_cache->insert(q_start->getCoord(), q_goal->getCoord(), env_hash, path_coords);
+        }
 
         RCLCPP_INFO(rclcpp::get_logger("rclcpp"), "\t Planning finished with %s ", 
             (result ? std::string("SUCCESS!").c_str() : std::string("FAILURE!").c_str()));
         if (result)
         {
-            RCLCPP_INFO(rclcpp::get_logger("rclcpp"), "\t Number of states in the path: %ld", planner->getPath().size());
-            RCLCPP_INFO(rclcpp::get_logger("rclcpp"), "\t Planning time: %f [ms]", planner->getPlannerInfo()->getPlanningTime() * 1e3);
-            if (planner_type == planning::PlannerType::RGBMTStar)
-                RCLCPP_INFO(rclcpp::get_logger("rclcpp"), "\t Path cost: %f", planner->getPlannerInfo()->getCostConvergence().back());
+            RCLCPP_INFO(rclcpp::get_logger("rclcpp"), "\t Number of states in the path: %ld", path.size());
+            RCLCPP_INFO(rclcpp::get_logger("rclcpp"), "\t Planning time: %f [ms]", planning_time * 1e3);
+            RCLCPP_INFO(rclcpp::get_logger("rclcpp"), "\t Path cost: %f", computePathCost(path));
         }
 
         // Just for debugging (Not recommended to waste time!)
@@ -143,6 +196,312 @@ bool sim_bringup::Planner::solve(std::shared_ptr<base::State> q_start, std::shar
     return result;
 }
 
+/// @brief Solve the problem through the roadmap (if used), and then by a new planner (or by a portfolio of planners), 
+/// which is stored in 'planner'.
+/// @param new_path Found path (output).
+bool sim_bringup::Planner::solveFromScratch(const std::shared_ptr<base::State> &q_start, const std::shared_ptr<base::State> &q_goal, 
+                                            float max_planning_time_, std::vector<std::shared_ptr<base::State>> &new_path)
+{
+    std::chrono::steady_clock::time_point time_start { std::chrono::steady_clock::now() };
+    if (roadmap != nullptr)
+    {
+        std::vector<Eigen::VectorXf> roadmap_path {};
+        if (roadmap->solve(scenario->getStateSpace(), q_start->getCoord(), q_goal->getCoord(), max_planning_time_, roadmap_path))
+        {
+            new_path = { q_start };
+            for (size_t i = 1; i < roadmap_path.size() - 1; i++)
+                new_path.emplace_back(scenario->getStateSpace()->getNewState(roadmap_path[i]));
+            new_path.emplace_back(q_goal);
+            return true;
+        }
+
+        RCLCPP_INFO(rclcpp::get_logger("rclcpp"), "\t Roadmap has no valid path. Using the fallback planner...");
+        max_planning_time_ -= std::chrono::duration<float>(std::chrono::steady_clock::now() - time_start).count();
+    }
+
+    bool result { false };
+    if (isPortfolio())
+        result = solvePortfolio(q_start, q_goal, max_planning_time_);
+    else
+    {
+        const size_t lease { acquireLease({ config.type }, max_planning_time_) };
+        try
+        {
+            planner = createPlanner(config.type, scenario->getStateSpace(), q_start, q_goal);
+            result = planner->solve();
+        }
+        catch (...)
+        {
+            releaseLease(lease);
+            throw;
+        }
+        releaseLease(lease);
+    }
+
+    if (result)
+        new_path = planner->getPath();
+
+    return result;
+}
+
+/// @brief Load the roadmap from its file, or build it (and save it) if the file does not exist 
+/// or the roadmap is built for a different static environment.
+/// @note It must be called while the environment contains only static objects, i.e., before any dynamic obstacle is added.
+void sim_bringup::Planner::initRoadmap()
+{
+    if (!config.use_roadmap)
+        return;
+
+    const size_t env_hash { PathCache::computeEnvironmentHash(scenario->getEnvironment()) };
+    roadmap = std::make_unique<sim_bringup::Roadmap>(config.roadmap_num_nodes, config.roadmap_num_neighbours);
+    if (!roadmap_file.empty() && roadmap->load(roadmap_file) && roadmap->getEnvironmentHash() == env_hash)
+        return;
+
+    RCLCPP_INFO(rclcpp::get_logger("rclcpp"), "Building the roadmap for the static environment...");
+    roadmap->build(scenario->getStateSpace(), env_hash);
+    if (!roadmap_file.empty())
+        roadmap->save(roadmap_file);
+}
+
+/// @brief Take the path cached for the same (quantised) problem in the same static environment, if it is still collision-free.
+/// Its end states are replaced by 'q_start' and 'q_goal', since they may differ from the cached ones by the cache resolution.
+/// @return Whether the cached path is valid, in which case it is stored in 'path'.
+bool sim_bringup::Planner::findCachedPath(const std::shared_ptr<base::State> &q_start, const std::shared_ptr<base::State> &q_goal, 
+                                          size_t env_hash)
+{
+    const std::vector<Eigen::VectorXf> *cached_path { path_cache->find(q_start->getCoord(), q_goal->getCoord(), env_hash) };
+    if (cached_path == nullptr || cached_path->size() < 2)
+        return false;
+
+    std::vector<std::shared_ptr<base::State>> new_path { q_start };
+    for (size_t i = 1; i < cached_path->size() - 1; i++)
+        new_path.emplace_back(scenario->getStateSpace()->getNewState(cached_path->at(i)));
+    new_path.emplace_back(q_goal);
+
+    if (!isPathValid(new_path))
+        return false;
+
+    path = std::move(new_path);
+    return true;
+}
+
+bool sim_bringup::Planner::isPathValid(const std::vector<std::shared_ptr<base::State>> &path_) const
+{
+    const std::shared_ptr<base::StateSpace> &ss { scenario->getStateSpace() };
+    for (size_t i = 0; i < path_.size(); i++)
+    {
+        if (!ss->isValid(path_[i]) || (i > 0 && !ss->isValid(path_[i-1], path_[i])))
+            return false;
+    }
+    
+    return true;
+}
+
+/// @brief Warm start: reuse the last found path when the goal is the same, since usually only a few obstacles have moved.
+/// The path is continued from its state closest to 'q_start'. Each blocked part of the path is bridged by planning
+/// only from the last valid state before it to the first valid state after it, while all other states are kept.
+/// @param q_start Start configuration.
+/// @param q_goal Goal configuration.
+/// @param max_planning_time_ Time limit in [s] for all bridges together.
+/// @return Whether the path is repaired. If false, 'path' is not modified, and the problem should be solved from scratch.
+bool sim_bringup::Planner::repairPath(const std::shared_ptr<base::State> &q_start, const std::shared_ptr<base::State> &q_goal, 
+                                      float max_planning_time_)
+{
+    if (path.size() < 2 || (path.back()->getCoord() - q_goal->getCoord()).norm() > 1e-3)
+        return false;
+
+    std::chrono::steady_clock::time_point time_start { std::chrono::steady_clock::now() };
+    const std::shared_ptr<base::StateSpace> &ss { scenario->getStateSpace() };
+    size_t idx_closest { 0 };
+    float d_min { INFINITY };
+    for (size_t i = 0; i < path.size(); i++)
+    {
+        float d { (path[i]->getCoord() - q_start->getCoord()).norm() };
+        if (d < d_min)
+        {
+            d_min = d;
+            idx_closest = i;
+        }
+    }
+
+    std::vector<std::shared_ptr<base::State>> new_path { q_start };
+    new_path.insert(new_path.end(), path.begin() + std::min(idx_closest + 1, path.size() - 1), path.end());
+
+    size_t i { 0 };
+    while (i < new_path.size() - 1)
+    {
+        if (ss->isValid(new_path[i+1]) && ss->isValid(new_path[i], new_path[i+1]))
+        {
+            i++;
+            continue;
+        }
+
+        size_t j { i + 1 };
+        while (j < new_path.size() - 1 && !ss->isValid(new_path[j]))
+            j++;
+
+        float time_remain { max_planning_time_ - std::chrono::duration<float>(std::chrono::steady_clock::now() - time_start).count() };
+        std::vector<std::shared_ptr<base::State>> bridge {};
+        if (time_remain <= 0 || !ss->isValid(new_path[j]) ||
+            !solveFromScratch(ss->getNewState(new_path[i]->getCoord()), ss->getNewState(new_path[j]->getCoord()), time_remain, bridge))
+            return false;
+
+        // The bridge replaces states strictly between 'i' and 'j'. Its edges are valid, so checking continues from 'j'.
+        if (bridge.size() < 2)
+            return false;
+
+        new_path.erase(new_path.begin() + i + 1, new_path.begin() + j);
+        new_path.insert(new_path.begin() + i + 1, bridge.begin() + 1, bridge.end() - 1);
+        i += bridge.size() - 1;
+    }
+
+    path = std::move(new_path);
+    return true;
+}
+
+/// @brief Make a running 'solve' (possibly called from another thread) terminate as soon as possible,
+/// by cancelling the time limits of its planners. Other 'Planner' instances are not affected.
+void sim_bringup::Planner::cancel()
+{
+    std::lock_guard<std::mutex> lock(leases_mutex);
+    for (size_t lease : leases)
+        StaticPlannerConfig::cancel(lease);
+}
+
+// 'leases_mutex' is not held while waiting for the lease, so 'cancel' is not blocked meanwhile
+size_t sim_bringup::Planner::acquireLease(const std::vector<planning::PlannerType> &types, float max_planning_time_)
+{
+    const size_t lease { StaticPlannerConfig::acquire(config, types, max_planning_time_) };
+    std::lock_guard<std::mutex> lock(leases_mutex);
+    leases.emplace_back(lease);
+    return lease;
+}
+
+void sim_bringup::Planner::releaseLease(size_t lease)
+{
+    std::lock_guard<std::mutex> lock(leases_mutex);
+    StaticPlannerConfig::release(lease);
+    leases.erase(std::remove(leases.begin(), leases.end(), lease), leases.end());
+}
+
+/// @brief Run all planners from the portfolio in parallel. The resulting planner is stored in 'planner'.
+/// @return Whether any planner finds a path.
+bool sim_bringup::Planner::solvePortfolio(const std::shared_ptr<base::State> &q_start, const std::shared_ptr<base::State> &q_goal, 
+                                          float max_planning_time_)
+{
+    const size_t num_planners { config.portfolio_types.size() };
+    if (thread_pool == nullptr)
+        thread_pool = std::make_unique<sim_bringup::ThreadPool>(num_planners);
+    
+    prepareStateSpaces(portfolio_state_spaces, num_planners);
+
+    // Planners modify their start and goal states (e.g., when building trees), so each of them gets its own copies
+    std::vector<std::unique_ptr<planning::AbstractPlanner>> planners(num_planners);
+    std::vector<std::future<bool>> results {};
+    std::atomic<int> idx_first { -1 };
+    const size_t lease { acquireLease(config.portfolio_types, max_planning_time_) };    // Shared by all planners
+    for (size_t i = 0; i < num_planners; i++)
+    {
+        results.emplace_back(thread_pool->submit([&, i]() -> bool
+        {
+            const std::shared_ptr<base::StateSpace> &ss { portfolio_state_spaces[i] };
+            planners[i] = createPlanner(config.portfolio_types[i], ss, ss->getNewState(q_start->getCoord()), ss->getNewState(q_goal->getCoord()));
+            if (idx_first != -1)    // Already found before this planner has started
+                return false;
+
+            bool result_ { planners[i]->solve() };
+            int idx { -1 };
+            if (result_ && config.portfolio_first_path && idx_first.compare_exchange_strong(idx, i))
+                cancel();   // Other planners are losers
+
+            return result_;
+        }));
+    }
+
+    int idx_best { -1 };
+    float cost_best { INFINITY };
+    for (size_t i = 0; i < num_planners; i++)
+    {
+        bool result_ { false };
+        try
+        {
+            result_ = results[i].get();
+        }
+        catch (std::exception &e)
+        {
+            RCLCPP_ERROR(rclcpp::get_logger("rclcpp"), "Portfolio planner %ld failed: %s", i, e.what());
+        }
+
+        if (!result_ || config.portfolio_first_path)
+            continue;
+
+        float cost { computePathCost(planners[i]->getPath()) };
+        if (cost < cost_best)
+        {
+            cost_best = cost;
+            idx_best = i;
+        }
+    }
+    releaseLease(lease);
+
+    if (config.portfolio_first_path)
+        idx_best = idx_first;
+
+    if (idx_best == -1)     // All planners failed, so any of them is kept (e.g., for its planner info)
+    {
+        for (std::unique_ptr<planning::AbstractPlanner> &planner_ : planners)
+        {
+            if (planner_ != nullptr)
+            {
+                planner = std::move(planner_);
+                break;
+            }
+        }
+        return false;
+    }
+
+    RCLCPP_INFO(rclcpp::get_logger("rclcpp"), "\t Portfolio planner %d is chosen.", idx_best);
+    planner = std::move(planners[idx_best]);
+    return true;
+}
+
+/// @brief Make sure that there are at least 'num' state spaces for parallel workers, each with its own robot instance.
+/// All of them share the environment, while the octree (if used) is taken from the main state space.
+void sim_bringup::Planner::prepareStateSpaces(std::vector<std::shared_ptr<base::StateSpace>> &state_spaces, size_t num) const
+{
+    while (state_spaces.size() < num)
+    {
+        if (state_space_factory != nullptr)
+            state_spaces.emplace_back(state_space_factory());
+        else
+        {
+            RCLCPP_WARN(rclcpp::get_logger("rclcpp"), "State space factory is not set! Parallel workers will share the state space.");
+            state_spaces.emplace_back(scenario->getStateSpace());
+        }
+    }
+
+    std::shared_ptr<sim_bringup::RealVectorSpaceOctree> ss_main 
+        { std::dynamic_pointer_cast<sim_bringup::RealVectorSpaceOctree>(scenario->getStateSpace()) };
+    if (ss_main == nullptr)
+        return;
+
+    for (const std::shared_ptr<base::StateSpace> &ss : state_spaces)
+    {
+        std::shared_ptr<sim_bringup::RealVectorSpaceOctree> ss_octree { std::dynamic_pointer_cast<sim_bringup::RealVectorSpaceOctree>(ss) };
+        if (ss_octree != nullptr)
+            ss_octree->setOctree(ss_main->getOctree());
+    }
+}
+
+float sim_bringup::Planner::computePathCost(const std::vector<std::shared_ptr<base::State>> &path) const
+{
+    float cost { 0 };
+    for (size_t i = 1; i < path.size(); i++)
+        cost += (path[i]->getCoord() - path[i-1]->getCoord()).norm();
+    
+    return cost;
+}
+
 /// @brief Generate a new path 'new_path' from a path 'original_path' in a way that the distance between two adjacent nodes
 /// is fixed (if possible) to a length of 'max_edge_length'. Geometrically, the new path remains the same as the original one,
 /// but only their nodes may differ.
@@ -153,7 +512,281 @@ void sim_bringup::Planner::preprocessPath(const std::vector<std::shared_ptr<base
     std::vector<std::shared_ptr<base::State>> &new_path, float max_edge_length_)
 {
     if (max_edge_length_ == -1)
-        max_edge_length_ = max_edge_length;
+        max_edge_length_ = config.max_edge_length;
     
     scenario->getStateSpace()->preprocessPath(original_path, new_path, max_edge_length_);
 }
+
+/// @brief Generate a new path 'new_path' from 'original_path' (as 'preprocessPath' does), and check it against the current environment.
+/// It should be called just before the path is executed, in order to catch a path which became invalid after planning.
+/// @return Index of the first invalid state of 'new_path' (or of the first state of its first invalid edge), or -1 if it is valid.
+int sim_bringup::Planner::preprocessAndValidatePath(const std::vector<std::shared_ptr<base::State>> &original_path, 
+    std::vector<std::shared_ptr<base::State>> &new_path, float max_edge_length_)
+{
+    preprocessPath(original_path, new_path, max_edge_length_);
+    return validatePath(new_path);
+}
+
+/// @brief Check all states and edges of 'path_' against the current environment.
+/// The path is split into contiguous segments, which are checked in parallel, each by its own state space.
+/// A segment stops as soon as an invalid state is found in it, or in any segment before it.
+/// @return Index of the first invalid state (or of the first state of the first invalid edge), or -1 if the path is valid.
+int sim_bringup::Planner::validatePath(const std::vector<std::shared_ptr<base::State>> &path_)
+{
+    // Short paths are not worth dispatching
+    const size_t min_segment_size { 8 };
+    const size_t num_segments { std::min(config.num_validation_threads, path_.size() / min_segment_size) };
+    std::atomic<int> idx_invalid { int(path_.size()) };
+    if (num_segments <= 1 || state_space_factory == nullptr)
+    {
+        int idx { validatePath(scenario->getStateSpace(), path_, 0, path_.size(), idx_invalid) };
+        return (idx < int(path_.size())) ? idx : -1;
+    }
+
+    if (validation_thread_pool == nullptr)
+        validation_thread_pool = std::make_unique<sim_bringup::ThreadPool>(config.num_validation_threads);
+    prepareStateSpaces(validation_state_spaces, num_segments);
+
+    std::vector<std::future<void>> results {};
+    for (size_t k = 0; k < num_segments; k++)
+    {
+        const size_t idx_begin { k * path_.size() / num_segments };
+        const size_t idx_end { (k + 1) * path_.size() / num_segments };
+        results.emplace_back(validation_thread_pool->submit([&, k, idx_begin, idx_end]()
+        {
+            int idx { validatePath(validation_state_spaces[k], path_, idx_begin, idx_end, idx_invalid) };
+            int idx_min { idx_invalid };
+            while (idx < idx_min && !idx_invalid.compare_exchange_weak(idx_min, idx)) {}
+        }));
+    }
+
+    for (std::future<void> &result : results)
+        result.get();
+
+    return (idx_invalid < int(path_.size())) ? int(idx_invalid) : -1;
+}
+
+/// @brief Validate several (short) paths in parallel, where each path is checked by a single worker with its own state space.
+/// @return For each path, the index of its first invalid state (or edge), or -1 if it is valid.
+std::vector<int> sim_bringup::Planner::validatePaths(const std::vector<std::vector<std::shared_ptr<base::State>>> &paths)
+{
+    std::vector<int> indices_invalid(paths.size(), -1);
+    auto validate = [&](const std::shared_ptr<base::StateSpace> &ss, size_t k)
+    {
+        const std::atomic<int> idx_invalid { int(paths[k].size()) };
+        int idx { validatePath(ss, paths[k], 0, paths[k].size(), idx_invalid) };
+        indices_invalid[k] = (idx < int(paths[k].size())) ? idx : -1;
+    };
+
+    const size_t num_workers { std::min(config.num_validation_threads, paths.size()) };
+    if (num_workers <= 1 || state_space_factory == nullptr)
+    {
+        for (size_t k = 0; k < paths.size(); k++)
+            validate(scenario->getStateSpace(), k);
+        
+        return indices_invalid;
+    }
+
+    if (validation_thread_pool == nullptr)
+        validation_thread_pool = std::make_unique<sim_bringup::ThreadPool>(config.num_validation_threads);
+    prepareStateSpaces(validation_state_spaces, num_workers);
+
+    std::vector<std::future<void>> results {};
+    for (size_t w = 0; w < num_workers; w++)
+    {
+        results.emplace_back(validation_thread_pool->submit([&, w]()
+        {
+            for (size_t k = w; k < paths.size(); k += num_workers)
+                validate(validation_state_spaces[w], k);
+        }));
+    }
+
+    for (std::future<void> &result : results)
+        result.get();
+
+    return indices_invalid;
+}
+
+/// @brief Check states with indices in ['idx_begin', 'idx_end'), and edges starting from them, using 'ss'.
+/// States are copied, since their additional data may be modified by 'ss', while neighbouring segments are checked in parallel.
+/// @return Index of the first invalid state (or edge) in the segment, or 'path_.size()' if there is none 
+/// (or if the checking is stopped since 'idx_invalid' is found before the segment).
+int sim_bringup::Planner::validatePath(const std::shared_ptr<base::StateSpace> &ss, const std::vector<std::shared_ptr<base::State>> &path_,
+                                       size_t idx_begin, size_t idx_end, const std::atomic<int> &idx_invalid)
+{
+    std::shared_ptr<base::State> q { nullptr };
+    std::shared_ptr<base::State> q_next { idx_begin < idx_end ? ss->getNewState(path_[idx_begin]->getCoord()) : nullptr };
+    for (size_t i = idx_begin; i < idx_end; i++)
+    {
+        if (idx_invalid < int(idx_begin))
+            break;
+
+        q = q_next;
+        if (!ss->isValid(q))
+            return i;
+
+        if (i + 1 < path_.size())
+        {
+            q_next = ss->getNewState(path_[i+1]->getCoord());
+            if (!ss->isValid(q, q_next))
+                return i;
+        }
+    }
+
+    return path_.size();
+}
+
+/// @brief Shorten 'path_' by replacing its parts with straight (collision-free) edges, within a time budget 'max_time'.
+/// In each round, every worker tries random pairs of non-adjacent states in parallel (each with its own state space), 
+/// and returns its valid shortcut with the largest gain. Non-overlapping shortcuts are then applied from the largest gain.
+/// The first and the last state (i.e., start and goal) are always kept. Shortcutting stops earlier when 
+/// 'config.shortcutting_max_idle_rounds' consecutive rounds do not shorten the path by a relative gain of at least 'min_gain'.
+void sim_bringup::Planner::shortcutPath(std::vector<std::shared_ptr<base::State>> &path_, float max_time)
+{
+    if (max_time <= 0 || path_.size() < 3)
+        return;
+
+    struct Shortcut
+    {
+        size_t i, j;
+        float gain;
+    };
+
+    std::chrono::steady_clock::time_point time_start { std::chrono::steady_clock::now() };
+    const size_t num_workers { (state_space_factory != nullptr) ? config.num_validation_threads : 1 };
+    const size_t num_attempts { 4 };        // Per worker and round
+    const float min_gain { 1e-3 };          // Relative to the path length
+    if (validation_thread_pool == nullptr)
+        validation_thread_pool = std::make_unique<sim_bringup::ThreadPool>(config.num_validation_threads);
+    prepareStateSpaces(validation_state_spaces, num_workers);
+
+    std::vector<std::mt19937> generators {};
+    std::random_device random_device {};
+    for (size_t k = 0; k < num_workers; k++)
+        generators.emplace_back(random_device());
+
+    std::vector<Eigen::VectorXf> coords {};
+    for (const std::shared_ptr<base::State> &q : path_)
+        coords.emplace_back(q->getCoord());
+
+    // Cumulative length along the path, used for computing a gain of each shortcut in constant time
+    std::vector<float> lengths(coords.size(), 0);
+    auto computeLengths = [&]()
+    {
+        lengths.assign(coords.size(), 0);
+        for (size_t i = 1; i < coords.size(); i++)
+            lengths[i] = lengths[i-1] + (coords[i] - coords[i-1]).norm();
+    };
+    computeLengths();
+
+    bool modified { false };
+    size_t num_idle_rounds { 0 };
+    while (coords.size() > 2 && num_idle_rounds < config.shortcutting_max_idle_rounds &&
+           std::chrono::duration<float>(std::chrono::steady_clock::now() - time_start).count() < max_time)
+    {
+        std::vector<std::future<Shortcut>> results {};
+        for (size_t k = 0; k < num_workers; k++)
+        {
+            results.emplace_back(validation_thread_pool->submit([&, k]() -> Shortcut
+            {
+                const std::shared_ptr<base::StateSpace> &ss { validation_state_spaces[k] };
+                std::uniform_int_distribution<size_t> distribution(0, coords.size() - 1);
+                Shortcut best { 0, 0, 0 };
+                for (size_t attempt = 0; attempt < num_attempts; attempt++)
+                {
+                    size_t i { distribution(generators[k]) };
+                    size_t j { distribution(generators[k]) };
+                    if (i > j)
+                        std::swap(i, j);
+
+                    const float gain { lengths[j] - lengths[i] - (coords[j] - coords[i]).norm() };
+                    if (j < i + 2 || gain <= best.gain)
+                        continue;
+
+                    if (ss->isValid(ss->getNewState(coords[i]), ss->getNewState(coords[j])))
+                        best = Shortcut { i, j, gain };
+                }
+                return best;
+            }));
+        }
+
+        std::vector<Shortcut> shortcuts {};
+        for (std::future<Shortcut> &result : results)
+        {
+            Shortcut shortcut { result.get() };
+            if (shortcut.gain > 0)
+                shortcuts.emplace_back(shortcut);
+        }
+
+        if (shortcuts.empty())
+        {
+            num_idle_rounds++;
+            continue;
+        }
+
+        std::sort(shortcuts.begin(), shortcuts.end(), [](const Shortcut &a, const Shortcut &b) { return a.gain > b.gain; });
+        std::vector<bool> removed(coords.size(), false);
+        std::vector<bool> used(coords.size(), false);       // States at the end of an applied shortcut may be shared
+        float gain { 0 };
+        for (const Shortcut &shortcut : shortcuts)
+        {
+            bool overlapping { false };
+            for (size_t idx = shortcut.i + 1; idx < shortcut.j && !overlapping; idx++)
+                overlapping = removed[idx] || used[idx];
+            if (overlapping || removed[shortcut.i] || removed[shortcut.j])
+                continue;
+
+            for (size_t idx = shortcut.i + 1; idx < shortcut.j; idx++)
+                removed[idx] = true;
+            used[shortcut.i] = used[shortcut.j] = true;
+            gain += shortcut.gain;
+        }
+        num_idle_rounds = (gain < min_gain * lengths.back()) ? num_idle_rounds + 1 : 0;
+
+        std::vector<Eigen::VectorXf> coords_new {};
+        for (size_t idx = 0; idx < coords.size(); idx++)
+        {
+            if (!removed[idx])
+                coords_new.emplace_back(coords[idx]);
+        }
+        coords = std::move(coords_new);
+        computeLengths();
+        modified = true;
+    }
+
+    if (!modified)
+        return;
+
+    std::vector<std::shared_ptr<base::State>> new_path { path_.front() };
+    for (size_t i = 1; i < coords.size() - 1; i++)
+        new_path.emplace_back(scenario->getStateSpace()->getNewState(coords[i]));
+    new_path.emplace_back(path_.back());
+    path_ = std::move(new_path);
+}
+
+/// @brief Smooth 'path_' by Chaikin's corner cutting, which converges to a quadratic B-spline through the path.
+/// In each iteration, every corner is replaced by two states at a quarter of its adjacent edges, 
+/// only if the new (cutting) edge is collision-free. Otherwise, the corner is kept.
+void sim_bringup::Planner::smoothPath(std::vector<std::shared_ptr<base::State>> &path_, size_t num_iterations)
+{
+    const std::shared_ptr<base::StateSpace> &ss { scenario->getStateSpace() };
+    for (size_t iteration = 0; iteration < num_iterations && path_.size() > 2; iteration++)
+    {
+        std::vector<std::shared_ptr<base::State>> new_path { path_.front() };
+        for (size_t i = 1; i < path_.size() - 1; i++)
+        {
+            const Eigen::VectorXf &q { path_[i]->getCoord() };
+            std::shared_ptr<base::State> q_A { ss->getNewState(q + 0.25 * (path_[i-1]->getCoord() - q)) };
+            std::shared_ptr<base::State> q_B { ss->getNewState(q + 0.25 * (path_[i+1]->getCoord() - q)) };
+            if (ss->isValid(q_A, q_B))
+            {
+                new_path.emplace_back(q_A);
+                new_path.emplace_back(q_B);
+            }
+            else
+                new_path.emplace_back(path_[i]);
+        }
+        new_path.emplace_back(path_.back());
+        path_ = std::move(new_path);
+    }
+}
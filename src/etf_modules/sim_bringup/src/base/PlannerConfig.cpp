@@ -0,0 +1,284 @@
+#include "base/PlannerConfig.h"
+
+#include <rclcpp/rclcpp.hpp>
+#include <algorithm>
+#include <thread>
+
+std::mutex sim_bringup::StaticPlannerConfig::mutex {};
+std::condition_variable sim_bringup::StaticPlannerConfig::released {};
+std::map<size_t, sim_bringup::StaticPlannerConfig::Lease> sim_bringup::StaticPlannerConfig::leases {};
+std::condition_variable sim_bringup::StaticPlannerConfig::leases_changed {};
+size_t sim_bringup::StaticPlannerConfig::next_lease { 0 };
+bool sim_bringup::StaticPlannerConfig::watchdog_running { false };
+
+/// @brief Read planner settings from 'planner_node'. Not specified optional settings keep their default values.
+/// @note 'StaticPlannerConfig::initConfiguration' should be called before, since some defaults are taken from it.
+sim_bringup::PlannerConfig sim_bringup::PlannerConfig::load(const YAML::Node &planner_node)
+{
+    PlannerConfig config {};
+    std::string type { planner_node["type"].as<std::string>() };
+    if (type == "PRM")
+    {
+        YAML::Node roadmap_node { planner_node["roadmap"] };
+        config.use_roadmap = true;
+        type = roadmap_node["fallback"].IsDefined() ? roadmap_node["fallback"].as<std::string>() : "RGBT-Connect";
+        if (roadmap_node["file"].IsDefined())
+            config.roadmap_file = roadmap_node["file"].as<std::string>();
+        if (roadmap_node["num_nodes"].IsDefined())
+            config.roadmap_num_nodes = roadmap_node["num_nodes"].as<size_t>();
+        if (roadmap_node["num_neighbours"].IsDefined())
+            config.roadmap_num_neighbours = roadmap_node["num_neighbours"].as<size_t>();
+    }
+    config.type = toPlannerType(type);
+
+    YAML::Node max_planning_time_node { planner_node["max_planning_time"] };
+    if (max_planning_time_node.IsDefined())
+        config.max_planning_time = max_planning_time_node.as<float>();
+
+    if (planner_node["max_edge_length"].IsDefined())
+        config.max_edge_length = planner_node["max_edge_length"].as<float>();
+    else
+        RCLCPP_WARN(rclcpp::get_logger("rclcpp"), "Maximal edge length is not defined! Using default value of %f", config.max_edge_length);
+
+    YAML::Node terminate_node { planner_node["terminate_when_path_is_found"] };
+    if (terminate_node.IsDefined())
+        config.terminate_when_path_is_found = terminate_node.as<bool>();
+    else
+    {
+        std::lock_guard<std::mutex> lock(StaticPlannerConfig::getMutex());
+        config.terminate_when_path_is_found = RGBMTStarConfig::TERMINATE_WHEN_PATH_IS_FOUND;
+    }
+
+    YAML::Node num_validation_threads_node { planner_node["num_validation_threads"] };
+    if (num_validation_threads_node.IsDefined())
+        config.num_validation_threads = std::max(num_validation_threads_node.as<size_t>(), size_t(1));
+
+    YAML::Node post_processing_node { planner_node["post_processing"] };
+    if (post_processing_node.IsDefined())
+    {
+        if (post_processing_node["shortcutting_time"].IsDefined())
+            config.shortcutting_time = post_processing_node["shortcutting_time"].as<float>();
+        if (post_processing_node["shortcutting_max_idle_rounds"].IsDefined())
+            config.shortcutting_max_idle_rounds = std::max(post_processing_node["shortcutting_max_idle_rounds"].as<size_t>(), size_t(1));
+        if (post_processing_node["smoothing_iterations"].IsDefined())
+            config.smoothing_iterations = post_processing_node["smoothing_iterations"].as<size_t>();
+    }
+
+    YAML::Node warm_start_node { planner_node["warm_start"] };
+    if (warm_start_node.IsDefined())
+        config.warm_start = warm_start_node.as<bool>();
+
+    YAML::Node path_cache_node { planner_node["path_cache"] };
+    if (path_cache_node.IsDefined())
+    {
+        config.use_path_cache = true;
+        if (path_cache_node["file"].IsDefined())
+            config.path_cache_file = path_cache_node["file"].as<std::string>();
+        if (path_cache_node["resolution"].IsDefined())
+            config.path_cache_resolution = path_cache_node["resolution"].as<float>();
+        if (path_cache_node["capacity"].IsDefined())
+            config.path_cache_capacity = path_cache_node["capacity"].as<size_t>();
+    }
+
+    YAML::Node portfolio_node { planner_node["portfolio"] };
+    if (portfolio_node.IsDefined())
+    {
+        for (size_t i = 0; i < portfolio_node["types"].size(); i++)
+            config.portfolio_types.emplace_back(toPlannerType(portfolio_node["types"][i].as<std::string>()));
+
+        if (portfolio_node["mode"].IsDefined())
+        {
+            std::string mode { portfolio_node["mode"].as<std::string>() };
+            if (mode == "best")
+                config.portfolio_first_path = false;
+            else if (mode != "first")
+                throw std::logic_error("Portfolio mode '" + mode + "' does not exist!");
+        }
+    }
+
+    return config;
+}
+
+planning::PlannerType sim_bringup::PlannerConfig::toPlannerType(const std::string &type)
+{
+    if (type == "RGBMT*")
+        return planning::PlannerType::RGBMTStar;
+    else if (type == "RGBT-Connect")
+        return planning::PlannerType::RGBTConnect;
+    else if (type == "RBT-Connect")
+        return planning::PlannerType::RBTConnect;
+    else if (type == "RRT-Connect")
+        return planning::PlannerType::RRTConnect;
+
+    throw std::logic_error("Planner type '" + type + "' does not exist!");
+}
+
+/// @brief Read all static RPMPL settings from 'configurations_file_path'.
+void sim_bringup::StaticPlannerConfig::initConfiguration(const std::string &configurations_file_path)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    ConfigurationReader::initConfiguration(configurations_file_path);
+}
+
+/// @brief Apply the settings of planners that are about to solve. If other running planners use RGBMT* with a different 
+/// 'terminate_when_path_is_found', it waits (at most 'MAX_WAIT_TIME') until they are finished.
+/// @param config Settings of the planners.
+/// @param types Planner types (they may differ from 'config.type' for portfolio planners).
+/// @param max_planning_time Time limit in [s] of this particular solving. The planners are cancelled when it expires.
+/// @return Lease, which must be released when the solving is finished.
+size_t sim_bringup::StaticPlannerConfig::acquire(const PlannerConfig &config, const std::vector<planning::PlannerType> &types, 
+    float max_planning_time)
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    Lease lease_ { types, max_planning_time, std::chrono::steady_clock::time_point::max(), config.terminate_when_path_is_found, false };
+    std::chrono::milliseconds max_wait_time { MAX_WAIT_TIME };
+    if (max_planning_time < std::chrono::duration<float>(MAX_WAIT_TIME).count())
+        max_wait_time = std::chrono::milliseconds(int64_t(std::max(max_planning_time, 0.f) * 1e3));
+    
+    const bool compatible { released.wait_for(lock, max_wait_time, [&lease_]() { return isCompatible(lease_); }) };
+    if (!compatible)
+    {
+        RCLCPP_WARN(rclcpp::get_logger("rclcpp"), "Planner settings are still used by conflicting planners. Proceeding with their settings...");
+        lease_.terminate_when_path_is_found = RGBMTStarConfig::TERMINATE_WHEN_PATH_IS_FOUND;
+    }
+    
+    if (std::isfinite(max_planning_time))
+        lease_.deadline = std::chrono::steady_clock::now() + 
+            std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<float>(std::max(max_planning_time, 0.f)));
+
+    const size_t lease { next_lease++ };
+    leases.emplace(lease, std::move(lease_));
+    for (planning::PlannerType type : types)
+    {
+        updateMaxPlanningTime(type);
+        if (type == planning::PlannerType::RGBMTStar && compatible)
+            RGBMTStarConfig::TERMINATE_WHEN_PATH_IS_FOUND = config.terminate_when_path_is_found;
+    }
+
+    if (!watchdog_running)
+    {
+        watchdog_running = true;
+        std::thread(&StaticPlannerConfig::watchdog).detach();
+    }
+    leases_changed.notify_one();
+    return lease;
+}
+
+// Settings of a released lease are left as they are, until they are overwritten by the next one
+void sim_bringup::StaticPlannerConfig::release(size_t lease)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        leases.erase(lease);
+    }
+    released.notify_all();
+    leases_changed.notify_one();
+}
+
+/// @brief Make the planners holding 'lease' terminate as soon as possible.
+/// If other (not cancelled) planners share some of their types, those types keep the largest time limit among them.
+void sim_bringup::StaticPlannerConfig::cancel(size_t lease)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it { leases.find(lease) };
+    if (it != leases.end())
+        cancel(it->second);
+}
+
+// Must be called with 'mutex' locked
+void sim_bringup::StaticPlannerConfig::cancel(Lease &lease)
+{
+    if (lease.cancelled)
+        return;
+
+    lease.cancelled = true;
+    for (planning::PlannerType type : lease.types)
+        updateMaxPlanningTime(type);
+}
+
+// Must be called with 'mutex' locked. Whether 'lease' can be applied without changing the settings of any active lease.
+// Time limits never conflict, since each lease is terminated at its own deadline.
+// A cancelled lease is not compatible with any other one of the same type, since its time limit may already be zero.
+bool sim_bringup::StaticPlannerConfig::isCompatible(const Lease &lease)
+{
+    for (const auto &[idx, data] : leases)
+    {
+        for (planning::PlannerType type : lease.types)
+        {
+            if (std::find(data.types.begin(), data.types.end(), type) == data.types.end())
+                continue;
+            
+            if (data.cancelled || 
+                (type == planning::PlannerType::RGBMTStar && data.terminate_when_path_is_found != lease.terminate_when_path_is_found))
+                return false;
+        }
+    }
+
+    return true;
+}
+
+// Must be called with 'mutex' locked. Set the time limit of 'type' to the largest configured one among the active 
+// (not cancelled) leases using it, or to zero if there is none.
+void sim_bringup::StaticPlannerConfig::updateMaxPlanningTime(planning::PlannerType type)
+{
+    float max_planning_time { 0 };
+    for (const auto &[idx, data] : leases)
+    {
+        if (!data.cancelled && std::find(data.types.begin(), data.types.end(), type) != data.types.end())
+            max_planning_time = std::max(max_planning_time, data.max_planning_time);
+    }
+
+    setMaxPlanningTime(type, max_planning_time);
+}
+
+// Cancel each lease when its deadline expires. The thread exits when there are no leases left.
+void sim_bringup::StaticPlannerConfig::watchdog()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    while (!leases.empty())
+    {
+        const std::chrono::steady_clock::time_point time_now { std::chrono::steady_clock::now() };
+        std::chrono::steady_clock::time_point deadline { std::chrono::steady_clock::time_point::max() };
+        for (auto &[idx, data] : leases)
+        {
+            if (data.cancelled)
+                continue;
+            
+            if (data.deadline <= time_now)
+                cancel(data);
+            else
+                deadline = std::min(deadline, data.deadline);
+        }
+
+        if (deadline == std::chrono::steady_clock::time_point::max())
+            leases_changed.wait(lock);
+        else
+            leases_changed.wait_until(lock, deadline);
+    }
+    watchdog_running = false;
+}
+
+void sim_bringup::StaticPlannerConfig::setMaxPlanningTime(planning::PlannerType type, float time)
+{
+    switch (type)
+    {
+    case planning::PlannerType::RGBMTStar:
+        RGBMTStarConfig::MAX_PLANNING_TIME = time;
+        break;
+
+    case planning::PlannerType::RGBTConnect:
+        RGBTConnectConfig::MAX_PLANNING_TIME = time;
+        break;
+
+    case planning::PlannerType::RBTConnect:
+        RBTConnectConfig::MAX_PLANNING_TIME = time;
+        break;
+
+    case planning::PlannerType::RRTConnect:
+        RRTConnectConfig::MAX_PLANNING_TIME = time;
+        break;
+
+    default:
+        break;
+    }
+}
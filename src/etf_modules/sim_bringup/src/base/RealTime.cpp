@@ -0,0 +1,64 @@
+#include "base/RealTime.h"
+
+#include <rclcpp/rclcpp.hpp>
+#include <sched.h>
+#include <sys/mman.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+/// @brief Pin a thread to a single CPU.
+/// @param thread Native thread handle.
+/// @param cpu Index of the CPU. If negative, the affinity is not changed.
+/// @return Whether the affinity is set.
+bool sim_bringup::setThreadAffinity(pthread_t thread, int cpu)
+{
+    if (cpu < 0)
+        return false;
+
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    CPU_SET(cpu, &cpu_set);
+    int error { pthread_setaffinity_np(thread, sizeof(cpu_set_t), &cpu_set) };
+    if (error != 0)
+    {
+        RCLCPP_WARN(rclcpp::get_logger("rclcpp"), "Cannot pin the thread to CPU %d: %s", cpu, std::strerror(error));
+        return false;
+    }
+
+    return true;
+}
+
+/// @brief Run a thread under SCHED_FIFO policy with a given priority.
+/// @param thread Native thread handle.
+/// @param priority Priority within SCHED_FIFO range (typically [1, 99]). If not positive, the scheduling is not changed.
+/// @return Whether the scheduling is set.
+bool sim_bringup::setThreadPriority(pthread_t thread, int priority)
+{
+    if (priority <= 0)
+        return false;
+
+    sched_param param {};
+    param.sched_priority = std::clamp(priority, sched_get_priority_min(SCHED_FIFO), sched_get_priority_max(SCHED_FIFO));
+    int error { pthread_setschedparam(thread, SCHED_FIFO, &param) };
+    if (error != 0)
+    {
+        RCLCPP_WARN(rclcpp::get_logger("rclcpp"), "Cannot set SCHED_FIFO priority %d: %s", param.sched_priority, std::strerror(error));
+        return false;
+    }
+
+    return true;
+}
+
+/// @brief Lock all current and future pages of the process into RAM, so that page faults do not occur in real-time loops.
+/// @return Whether the memory is locked.
+bool sim_bringup::lockMemory()
+{
+    if (mlockall(MCL_CURRENT | MCL_FUTURE) != 0)
+    {
+        RCLCPP_WARN(rclcpp::get_logger("rclcpp"), "Cannot lock the memory: %s", std::strerror(errno));
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,126 @@
+#include "base/ReplanningWorker.h"
+#include "base/RealTime.h"
+
+#include <rclcpp/rclcpp.hpp>
+
+sim_bringup::ReplanningWorker::ReplanningWorker(const std::function<void()> &on_cancel_) :
+    on_cancel(on_cancel_)
+{
+    pending_job = nullptr;
+    has_running_job = false;
+    running = false;
+    busy.store(false, std::memory_order_relaxed);
+}
+
+sim_bringup::ReplanningWorker::~ReplanningWorker()
+{
+    stop();
+}
+
+/// @brief Start the worker thread.
+/// @param cpu CPU to which the thread is pinned. If negative, the thread is not pinned.
+/// @param priority SCHED_FIFO priority of the thread. If not positive, the default scheduling is used.
+void sim_bringup::ReplanningWorker::start(int cpu, int priority)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (running)
+            return;
+
+        running = true;
+    }
+
+    thread = std::thread(&ReplanningWorker::run, this);
+    setThreadAffinity(thread.native_handle(), cpu);
+    setThreadPriority(thread.native_handle(), priority);
+}
+
+/// @brief Cancel all jobs and wait for the worker thread to finish.
+void sim_bringup::ReplanningWorker::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        running = false;
+        pending_job = nullptr;
+        pending_token.cancel();
+        cancelRunningJob();
+    }
+    condition.notify_one();
+
+    if (thread.joinable())
+        thread.join();
+}
+
+/// @brief Put 'job' into the mailbox. A pending job is replaced, and a running job is cancelled.
+void sim_bringup::ReplanningWorker::submit(Job job)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!running)
+        {
+            RCLCPP_WARN(rclcpp::get_logger("rclcpp"), "Replanning worker is not started! The job is dropped.");
+            return;
+        }
+
+        pending_token.cancel();
+        cancelRunningJob();
+        pending_job = std::move(job);
+        pending_token = CancellationToken();
+        busy.store(true, std::memory_order_release);
+    }
+    condition.notify_one();
+}
+
+/// @brief Drop a pending job and cancel a running one.
+void sim_bringup::ReplanningWorker::cancel()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    pending_job = nullptr;
+    pending_token.cancel();
+    cancelRunningJob();
+}
+
+// Must be called while holding 'mutex'
+void sim_bringup::ReplanningWorker::cancelRunningJob()
+{
+    if (!has_running_job || running_token.isCancelled())
+        return;
+
+    running_token.cancel();
+    if (on_cancel != nullptr)
+        on_cancel();
+}
+
+void sim_bringup::ReplanningWorker::run()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true)
+    {
+        condition.wait(lock, [this] { return !running || pending_job != nullptr; });
+        if (!running)
+            break;
+
+        Job job { std::move(pending_job) };
+        pending_job = nullptr;
+        running_token = pending_token;
+        has_running_job = true;
+
+        lock.unlock();
+        try
+        {
+            job(running_token);
+        }
+        catch (std::exception &e)
+        {
+            RCLCPP_ERROR(rclcpp::get_logger("rclcpp"), "Replanning job failed: %s", e.what());
+        }
+        lock.lock();
+
+        has_running_job = false;
+        if (pending_job == nullptr)
+            busy.store(false, std::memory_order_release);
+    }
+
+    has_running_job = false;
+    busy.store(false, std::memory_order_release);
+}
@@ -0,0 +1,318 @@
+#include "base/Roadmap.h"
+
+#include <rclcpp/rclcpp.hpp>
+#include <yaml-cpp/yaml.h>
+#include <algorithm>
+#include <fstream>
+#include <queue>
+
+sim_bringup::Roadmap::Roadmap(size_t num_nodes_, size_t num_neighbours_)
+{
+    num_nodes = num_nodes_;
+    num_neighbours = std::max(num_neighbours_, size_t(1));
+    env_hash = 0;
+}
+
+/// @brief Build the roadmap by sampling 'num_nodes' valid configurations and connecting each of them
+/// to its 'num_neighbours' nearest nodes by valid edges.
+/// @param ss State space, whose environment must contain only static objects.
+/// @param env_hash_ Hash of the static environment, which is stored in order to detect an outdated roadmap.
+void sim_bringup::Roadmap::build(const std::shared_ptr<base::StateSpace> &ss, size_t env_hash_)
+{
+    std::chrono::steady_clock::time_point time_start { std::chrono::steady_clock::now() };
+    env_hash = env_hash_;
+    nodes.clear();
+    edges.clear();
+
+    for (size_t num_attempts = 0; nodes.size() < num_nodes && num_attempts < 100 * num_nodes; num_attempts++)
+    {
+        std::shared_ptr<base::State> q { ss->getRandomState() };
+        if (ss->isValid(q))
+            nodes.emplace_back(q->getCoord());
+    }
+
+    edges.resize(nodes.size());
+    for (size_t i = 0; i < nodes.size(); i++)
+    {
+        std::shared_ptr<base::State> q { ss->getNewState(nodes[i]) };
+        for (size_t j : findNearest(nodes[i], num_neighbours + 1, nodes.size()))
+        {
+            // The pair may be already checked from the node 'j'
+            if (j == i || std::find_if(edges[i].begin(), edges[i].end(), [j](const Edge &edge) { return edge.node == j; })
+                != edges[i].end())
+                continue;
+
+            if (ss->isValid(q, ss->getNewState(nodes[j])))
+                addEdge(i, j);
+        }
+    }
+
+    size_t num_edges { 0 };
+    for (const std::vector<Edge> &edges_ : edges)
+        num_edges += edges_.size();
+
+    RCLCPP_INFO(rclcpp::get_logger("rclcpp"), "Roadmap with %ld nodes and %ld edges is built in %f [s].",
+        nodes.size(), num_edges / 2, std::chrono::duration<float>(std::chrono::steady_clock::now() - time_start).count());
+}
+
+/// @brief Find a path from 'q_start' to 'q_goal' through the roadmap, which is valid in the current environment of 'ss'.
+/// @param ss State space containing the current environment (including dynamic obstacles).
+/// @param q_start Start configuration.
+/// @param q_goal Goal configuration.
+/// @param max_planning_time Time limit in [s].
+/// @param path Found path (output).
+/// @return Whether the path is found.
+bool sim_bringup::Roadmap::solve(const std::shared_ptr<base::StateSpace> &ss, const Eigen::VectorXf &q_start,
+    const Eigen::VectorXf &q_goal, float max_planning_time, std::vector<Eigen::VectorXf> &path)
+{
+    if (nodes.empty())
+        return false;
+
+    std::chrono::steady_clock::time_point time_start { std::chrono::steady_clock::now() };
+    const size_t num_nodes_static { nodes.size() };
+    const size_t idx_start { addQueryNode(q_start, num_nodes_static) };
+    const size_t idx_goal { addQueryNode(q_goal, num_nodes_static) };
+    addEdge(idx_start, idx_goal);       // Trivial queries are answered directly
+
+    nodes_status.assign(nodes.size(), Status::Unknown);
+    edges_status.clear();
+
+    bool result { false };
+    std::vector<size_t> path_indices {};
+    while (std::chrono::duration<float>(std::chrono::steady_clock::now() - time_start).count() < max_planning_time)
+    {
+        if (!searchShortestPath(idx_start, idx_goal, path_indices))
+            break;
+
+        // Nodes are cheaper to check than edges, so all of them are checked first
+        bool valid { true };
+        for (size_t idx : path_indices)
+        {
+            if (nodes_status[idx] == Status::Unknown)
+                nodes_status[idx] = ss->isValid(ss->getNewState(nodes[idx])) ? Status::Valid : Status::Invalid;
+
+            if (nodes_status[idx] == Status::Invalid)
+            {
+                valid = false;
+                break;
+            }
+        }
+
+        for (size_t i = 1; valid && i < path_indices.size(); i++)
+        {
+            Status &status { getEdgeStatus(path_indices[i-1], path_indices[i]) };
+            if (status == Status::Unknown)
+                status = ss->isValid(ss->getNewState(nodes[path_indices[i-1]]), ss->getNewState(nodes[path_indices[i]])) ?
+                         Status::Valid : Status::Invalid;
+
+            valid = (status == Status::Valid);
+        }
+
+        if (valid)
+        {
+            path.clear();
+            for (size_t idx : path_indices)
+                path.emplace_back(nodes[idx]);
+
+            result = true;
+            break;
+        }
+    }
+
+    removeQueryNodes(num_nodes_static);
+    return result;
+}
+
+/// @brief Save the roadmap to a yaml file 'file_path'.
+bool sim_bringup::Roadmap::save(const std::string &file_path) const
+{
+    YAML::Node node {};
+    node["env_hash"] = std::to_string(env_hash);
+    for (const Eigen::VectorXf &q : nodes)
+    {
+        YAML::Node q_node {};
+        for (long k = 0; k < q.size(); k++)
+            q_node.push_back(q(k));
+        q_node.SetStyle(YAML::EmitterStyle::Flow);
+        node["nodes"].push_back(q_node);
+    }
+
+    for (size_t i = 0; i < edges.size(); i++)
+    {
+        for (const Edge &edge : edges[i])
+        {
+            if (edge.node < i)
+                continue;
+
+            YAML::Node edge_node {};
+            edge_node.push_back(i);
+            edge_node.push_back(edge.node);
+            edge_node.SetStyle(YAML::EmitterStyle::Flow);
+            node["edges"].push_back(edge_node);
+        }
+    }
+
+    std::ofstream file_out(file_path, std::ofstream::out);
+    if (!file_out.is_open())
+    {
+        RCLCPP_WARN(rclcpp::get_logger("rclcpp"), "Roadmap cannot be saved to %s", file_path.c_str());
+        return false;
+    }
+
+    file_out << node;
+    return true;
+}
+
+/// @brief Load the roadmap from a yaml file 'file_path' (previously created by 'save').
+/// @return Whether the file is loaded.
+bool sim_bringup::Roadmap::load(const std::string &file_path)
+{
+    YAML::Node node {};
+    try
+    {
+        node = YAML::LoadFile(file_path);
+    }
+    catch (std::exception &e)
+    {
+        RCLCPP_INFO(rclcpp::get_logger("rclcpp"), "Roadmap is not loaded from %s", file_path.c_str());
+        return false;
+    }
+
+    nodes.clear();
+    edges.clear();
+    env_hash = std::stoull(node["env_hash"].as<std::string>());
+    for (size_t i = 0; i < node["nodes"].size(); i++)
+    {
+        YAML::Node q_node { node["nodes"][i] };
+        Eigen::VectorXf q(q_node.size());
+        for (size_t k = 0; k < q_node.size(); k++)
+            q(k) = q_node[k].as<float>();
+        nodes.emplace_back(q);
+    }
+
+    edges.resize(nodes.size());
+    for (size_t i = 0; i < node["edges"].size(); i++)
+    {
+        size_t idx1 { node["edges"][i][0].as<size_t>() };
+        size_t idx2 { node["edges"][i][1].as<size_t>() };
+        if (idx1 >= nodes.size() || idx2 >= nodes.size())
+            throw std::logic_error("Roadmap in " + file_path + " is corrupted!");
+
+        addEdge(idx1, idx2);
+    }
+
+    RCLCPP_INFO(rclcpp::get_logger("rclcpp"), "Loaded roadmap with %ld nodes from %s", nodes.size(), file_path.c_str());
+    return true;
+}
+
+/// @brief Find (at most) 'k' nodes nearest to 'q' among the first 'num_searched' nodes.
+std::vector<size_t> sim_bringup::Roadmap::findNearest(const Eigen::VectorXf &q, size_t k, size_t num_searched) const
+{
+    std::vector<std::pair<float, size_t>> distances(num_searched);
+    for (size_t i = 0; i < num_searched; i++)
+        distances[i] = { (nodes[i] - q).squaredNorm(), i };
+
+    k = std::min(k, num_searched);
+    std::partial_sort(distances.begin(), distances.begin() + k, distances.end());
+
+    std::vector<size_t> nearest(k);
+    for (size_t i = 0; i < k; i++)
+        nearest[i] = distances[i].second;
+
+    return nearest;
+}
+
+void sim_bringup::Roadmap::addEdge(size_t idx1, size_t idx2)
+{
+    const float length { (nodes[idx1] - nodes[idx2]).norm() };
+    edges[idx1].emplace_back(Edge { idx2, length });
+    edges[idx2].emplace_back(Edge { idx1, length });
+}
+
+// Query node is connected to its nearest static nodes without any checking (edges are validated lazily)
+size_t sim_bringup::Roadmap::addQueryNode(const Eigen::VectorXf &q, size_t num_nodes_static)
+{
+    const std::vector<size_t> nearest { findNearest(q, num_neighbours, num_nodes_static) };
+    nodes.emplace_back(q);
+    edges.emplace_back();
+    for (size_t idx : nearest)
+        addEdge(nodes.size() - 1, idx);
+
+    return nodes.size() - 1;
+}
+
+// Edges of query nodes are the last ones in the lists of their neighbours
+void sim_bringup::Roadmap::removeQueryNodes(size_t num_nodes_static)
+{
+    for (size_t i = num_nodes_static; i < nodes.size(); i++)
+    {
+        for (const Edge &edge : edges[i])
+        {
+            if (edge.node < num_nodes_static)
+                edges[edge.node].pop_back();
+        }
+    }
+
+    nodes.resize(num_nodes_static);
+    edges.resize(num_nodes_static);
+}
+
+/// @brief A* search for the shortest path from 'idx_start' to 'idx_goal', which avoids nodes and edges known to be invalid.
+bool sim_bringup::Roadmap::searchShortestPath(size_t idx_start, size_t idx_goal, std::vector<size_t> &path_indices) const
+{
+    if (nodes_status[idx_start] == Status::Invalid || nodes_status[idx_goal] == Status::Invalid)
+        return false;
+
+    const size_t none { nodes.size() };
+    std::vector<float> cost(nodes.size(), INFINITY);
+    std::vector<size_t> parent(nodes.size(), none);
+    std::vector<bool> closed(nodes.size(), false);
+    std::priority_queue<std::pair<float, size_t>, std::vector<std::pair<float, size_t>>, std::greater<>> open {};
+
+    cost[idx_start] = 0;
+    open.emplace((nodes[idx_start] - nodes[idx_goal]).norm(), idx_start);
+    while (!open.empty())
+    {
+        const size_t idx { open.top().second };
+        open.pop();
+        if (closed[idx])
+            continue;
+
+        closed[idx] = true;
+        if (idx == idx_goal)
+            break;
+
+        for (const Edge &edge : edges[idx])
+        {
+            if (closed[edge.node] || nodes_status[edge.node] == Status::Invalid)
+                continue;
+
+            auto it { edges_status.find(std::min(idx, edge.node) * nodes.size() + std::max(idx, edge.node)) };
+            if (it != edges_status.end() && it->second == Status::Invalid)
+                continue;
+
+            const float cost_new { cost[idx] + edge.length };
+            if (cost_new < cost[edge.node])
+            {
+                cost[edge.node] = cost_new;
+                parent[edge.node] = idx;
+                open.emplace(cost_new + (nodes[edge.node] - nodes[idx_goal]).norm(), edge.node);
+            }
+        }
+    }
+
+    if (!closed[idx_goal])
+        return false;
+
+    path_indices.clear();
+    for (size_t idx = idx_goal; idx != none; idx = parent[idx])
+        path_indices.emplace_back(idx);
+
+    std::reverse(path_indices.begin(), path_indices.end());
+    return true;
+}
+
+sim_bringup::Roadmap::Status &sim_bringup::Roadmap::getEdgeStatus(size_t idx1, size_t idx2)
+{
+    return edges_status.try_emplace(std::min(idx1, idx2) * nodes.size() + std::max(idx1, idx2), Status::Unknown).first->second;
+}
@@ -22,26 +22,21 @@ sim_bringup::Robot::Robot(const std::string &config_file_path)
             home_joints_position(i) = q_home_node[i].as<float>();
 
         YAML::Node gripper_length_node { robot_node["gripper_length"] };
-        float gripper_length { 0 };
+        gripper_length = 0;
         if (gripper_length_node.IsDefined())
             gripper_length = gripper_length_node.as<float>();
         else
             RCLCPP_WARN(rclcpp::get_logger("rclcpp"), "Gripper is not included!");
 
         YAML::Node table_included_node { robot_node["table_included"] };
-        bool table_included { false }; 
+        table_included = false; 
         if (table_included_node.IsDefined()) 
             table_included = table_included_node.as<bool>();
         else
             RCLCPP_WARN(rclcpp::get_logger("rclcpp"), "Table is not included in the scene!");
 
-        std::string type { robot_node["type"].as<std::string>() };
-        if (type == "xarm6")
-            robot = std::make_shared<robots::xArm6>(project_abs_path + robot_node["urdf"].as<std::string>(),
-                                                    gripper_length,
-                                                    table_included);
-        else
-            throw std::logic_error("Robot type is not specified!");
+        robot_type = robot_node["type"].as<std::string>();
+        urdf_path = project_abs_path + robot_node["urdf"].as<std::string>();
 
         YAML::Node capsules_radius_node { robot_node["capsules_radius"] };
         if (capsules_radius_node.IsDefined())
@@ -49,11 +44,8 @@ sim_bringup::Robot::Robot(const std::string &config_file_path)
             if (capsules_radius_node.size() != num_DOFs)
                 throw std::logic_error("Number of capsules is not correct!");
                 
-            std::vector<float> capsules_radius {};
             for (size_t i = 0; i < num_DOFs; i++)
                 capsules_radius.emplace_back(capsules_radius_node[i].as<float>());
-
-            robot->setCapsulesRadius(capsules_radius);
         }
         else
             RCLCPP_WARN(rclcpp::get_logger("rclcpp"), "Radii of robot's capsules are not defined! Considering all zeros.");
@@ -64,11 +56,9 @@ sim_bringup::Robot::Robot(const std::string &config_file_path)
             if (max_vel_node.size() != num_DOFs)
                 throw std::logic_error("The size of 'max_vel' is not correct!");
 
-            Eigen::VectorXf max_vel(num_DOFs);
+            max_vel = Eigen::VectorXf(num_DOFs);
             for (size_t i = 0; i < num_DOFs; i++)
                 max_vel(i) = max_vel_node[i].as<float>();
-
-            robot->setMaxVel(max_vel);
         }
         else
             RCLCPP_WARN(rclcpp::get_logger("rclcpp"), "Maximal robot's joint velocity is not defined!");
@@ -79,11 +69,9 @@ sim_bringup::Robot::Robot(const std::string &config_file_path)
             if (max_acc_node.size() != num_DOFs)
                 throw std::logic_error("The size of 'max_acc' is not correct!");
 
-            Eigen::VectorXf max_acc(num_DOFs);
+            max_acc = Eigen::VectorXf(num_DOFs);
             for (size_t i = 0; i < num_DOFs; i++)
                 max_acc(i) = max_acc_node[i].as<float>();
-
-            robot->setMaxAcc(max_acc);
         }
         else
             RCLCPP_WARN(rclcpp::get_logger("rclcpp"), "Maximal robot's joint acceleration is not defined!");
@@ -94,11 +82,9 @@ sim_bringup::Robot::Robot(const std::string &config_file_path)
             if (max_jerk_node.size() != num_DOFs)
                 throw std::logic_error("The size of 'max_jerk' is not correct!");
 
-            Eigen::VectorXf max_jerk(num_DOFs);
+            max_jerk = Eigen::VectorXf(num_DOFs);
             for (size_t i = 0; i < num_DOFs; i++)
                 max_jerk(i) = max_jerk_node[i].as<float>();
-                
-            robot->setMaxJerk(max_jerk);
         }
         else
             RCLCPP_WARN(rclcpp::get_logger("rclcpp"), "Maximal robot's joint jerk is not defined!");
@@ -120,6 +106,8 @@ sim_bringup::Robot::Robot(const std::string &config_file_path)
             max_lin_jerk = max_lin_jerk_node.as<float>();
         else
             RCLCPP_WARN(rclcpp::get_logger("rclcpp"), "Maximal robot's linear jerk is not defined!");
+
+        robot = createRobot();
     }
     catch (std::exception &e)
     {
@@ -129,18 +117,75 @@ sim_bringup::Robot::Robot(const std::string &config_file_path)
     joints_position = Eigen::VectorXf(num_DOFs);
     joints_velocity = Eigen::VectorXf(num_DOFs);
     joints_acceleration = Eigen::VectorXf(num_DOFs);
+    joints_state_buffer = StateBuffer(num_DOFs);
+    joints_state_latency = Histogram(1, 200);
+    clock = nullptr;
     ready = false;
 }
 
+/// @brief Create a new instance of the robot, as specified in the configuration file.
+/// Since the robot model keeps its state (e.g., computed skeleton) while checking collisions, 
+/// each thread which plans in parallel requires its own instance.
+std::shared_ptr<robots::AbstractRobot> sim_bringup::Robot::createRobot() const
+{
+    std::shared_ptr<robots::AbstractRobot> robot_ { nullptr };
+    if (robot_type == "xarm6")
+        robot_ = std::make_shared<robots::xArm6>(urdf_path, gripper_length, table_included);
+    else
+        throw std::logic_error("Robot type is not specified!");
+
+    if (!capsules_radius.empty())
+        robot_->setCapsulesRadius(capsules_radius);
+    if (max_vel.size() > 0)
+        robot_->setMaxVel(max_vel);
+    if (max_acc.size() > 0)
+        robot_->setMaxAcc(max_acc);
+    if (max_jerk.size() > 0)
+        robot_->setMaxJerk(max_jerk);
+
+    return robot_;
+}
+
+/// @brief Get the joint state at 'time', interpolated between the received joint states, 
+/// or extrapolated from the latest one if 'time' is after it.
+/// @param time Time instance (e.g., the start of a planning iteration).
+/// @param position Joints position at 'time' (output).
+/// @param velocity Joints velocity at 'time' (output).
+/// @return Whether the joint state is obtained, i.e., whether any joint state has been received.
+bool sim_bringup::Robot::getJointsState(const rclcpp::Time &time, Eigen::VectorXf &position, Eigen::VectorXf &velocity) const
+{
+    return joints_state_buffer.query(time.seconds(), position, velocity);
+}
+
+/// @brief Get the age in [s] of the latest received joint state at 'time' (i.e., the end-to-end latency when it is used at 'time').
+float sim_bringup::Robot::getJointsStateAge(const rclcpp::Time &time) const
+{
+    if (joints_state_buffer.empty())
+        return INFINITY;
+
+    return time.seconds() - joints_state_buffer.getLatestTime();
+}
+
 void sim_bringup::Robot::jointsStateCallback(const control_msgs::msg::JointTrajectoryControllerState::SharedPtr msg)
 {
     ready = false;
-    for (size_t i = 0; i < num_DOFs; i++)
+    dispatchNumDOFs(num_DOFs, [&](auto N)
     {
-        joints_position(i) = msg->actual.positions[i];
-        joints_velocity(i) = msg->actual.velocities[i];
-        // joints_acceleration(i) = msg->actual.accelerations[i];   // Not supported for xarm6.
-    }
+        constexpr int n { decltype(N)::value };
+        joints_position = Eigen::Map<const VectorNd<n>>(msg->actual.positions.data(), num_DOFs).template cast<float>();
+        joints_velocity = Eigen::Map<const VectorNd<n>>(msg->actual.velocities.data(), num_DOFs).template cast<float>();
+        // joints_acceleration = Eigen::Map<const VectorNd<n>>(msg->actual.accelerations.data(), num_DOFs).template cast<float>();   // Not supported for xarm6.
+    });
+
+    // Controllers which do not stamp their messages are considered to have no latency
+    rclcpp::Time time_received { clock != nullptr ? clock->now() : rclcpp::Time(0, 0, RCL_ROS_TIME) };
+    rclcpp::Time time_stamp { msg->header.stamp, RCL_ROS_TIME };
+    if (time_stamp.nanoseconds() == 0 || clock == nullptr)
+        time_stamp = time_received;
+    else
+        joints_state_latency.add((time_received - time_stamp).seconds() * 1e3);
+    
+    joints_state_buffer.add(time_stamp.seconds(), joints_position, joints_velocity);
 	ready = true;
     
     // if (num_DOFs == 6)
@@ -156,10 +201,13 @@ void sim_bringup::Robot::jointsStateCallback(const control_msgs::msg::JointTraje
 
 bool sim_bringup::Robot::isReached(std::shared_ptr<base::State> q, float tol)
 {
-    if ((joints_position - q->getCoord()).norm() < tol)
-        return true;
-
-    return false;
+    const Eigen::VectorXf &q_coord { q->getCoord() };
+    return dispatchNumDOFs(num_DOFs, [&](auto N)
+    {
+        constexpr int n { decltype(N)::value };
+        return (Eigen::Map<const VectorNf<n>>(joints_position.data(), num_DOFs) - 
+                Eigen::Map<const VectorNf<n>>(q_coord.data(), num_DOFs)).squaredNorm() < tol * tol;
+    });
 }
 
 // Close gripper: position = 0.0
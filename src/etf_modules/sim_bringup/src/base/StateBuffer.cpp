@@ -0,0 +1,91 @@
+#include "base/StateBuffer.h"
+
+#include <algorithm>
+
+sim_bringup::StateBuffer::StateBuffer(size_t num_DOFs, size_t capacity_, float max_extrapolation_)
+{
+    capacity = std::max(capacity_, size_t(2));
+    max_extrapolation = max_extrapolation_;
+    times = std::vector<double>(capacity, 0);
+    positions = std::vector<Eigen::VectorXf>(capacity, Eigen::VectorXf::Zero(num_DOFs));
+    velocities = std::vector<Eigen::VectorXf>(capacity, Eigen::VectorXf::Zero(num_DOFs));
+    clear();
+}
+
+/// @brief Add a new sample. If the buffer is full, the oldest sample is overwritten.
+/// @param time Time instance of the sample in [s].
+/// @param position Position.
+/// @param velocity Velocity.
+/// @return Whether the sample is added. Samples older than the latest one are discarded,
+/// while a sample with the same time replaces the latest one.
+bool sim_bringup::StateBuffer::add(double time, const Eigen::VectorXf &position, const Eigen::VectorXf &velocity)
+{
+    if (size > 0 && time < getLatestTime())
+        return false;
+
+    size_t i {};
+    if (size > 0 && time == getLatestTime())
+        i = idx(size - 1);
+    else if (size < capacity)
+        i = idx(size++);
+    else
+    {
+        i = head;
+        head = idx(1);
+    }
+
+    times[i] = time;
+    positions[i] = position;
+    velocities[i] = velocity;
+    return true;
+}
+
+/// @brief Get the state at 'time'.
+/// @param time Time instance in [s].
+/// @param position Position at 'time' (output).
+/// @param velocity Velocity at 'time' (output).
+/// @return Whether the state is obtained. It is false if the buffer is empty.
+/// If 'time' is before the oldest sample, the oldest sample is returned.
+bool sim_bringup::StateBuffer::query(double time, Eigen::VectorXf &position, Eigen::VectorXf &velocity) const
+{
+    if (size == 0)
+        return false;
+
+    const size_t latest { idx(size - 1) };
+    if (time >= times[latest])
+    {
+        float dt { float(std::min(time - times[latest], double(max_extrapolation))) };
+        position = positions[latest] + velocities[latest] * dt;
+        velocity = velocities[latest];
+        return true;
+    }
+
+    if (time <= times[head])
+    {
+        position = positions[head];
+        velocity = velocities[head];
+        return true;
+    }
+
+    // The newest samples are the most likely to be queried, so the search goes backwards
+    size_t k { size - 1 };
+    while (k > 0 && times[idx(k - 1)] > time)
+        k--;
+
+    const size_t i0 { idx(k - 1) };
+    const size_t i1 { idx(k) };
+    const float h { float(times[i1] - times[i0]) };
+    const float s { float(time - times[i0]) / h };
+    const float s2 { s * s };
+    const float s3 { s2 * s };
+    position = (2 * s3 - 3 * s2 + 1) * positions[i0] + (s3 - 2 * s2 + s) * h * velocities[i0]
+             + (-2 * s3 + 3 * s2) * positions[i1] + (s3 - s2) * h * velocities[i1];
+    velocity = (1 - s) * velocities[i0] + s * velocities[i1];
+    return true;
+}
+
+void sim_bringup::StateBuffer::clear()
+{
+    head = 0;
+    size = 0;
+}
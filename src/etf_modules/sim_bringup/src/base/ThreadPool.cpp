@@ -0,0 +1,41 @@
+#include "base/ThreadPool.h"
+
+#include <algorithm>
+
+sim_bringup::ThreadPool::ThreadPool(size_t num_threads)
+{
+    running = true;
+    for (size_t i = 0; i < std::max(num_threads, size_t(1)); i++)
+        threads.emplace_back(&ThreadPool::run, this);
+}
+
+// Queued tasks are still executed, so all returned futures become ready
+sim_bringup::ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        running = false;
+    }
+    condition.notify_all();
+
+    for (std::thread &thread : threads)
+        thread.join();
+}
+
+void sim_bringup::ThreadPool::run()
+{
+    while (true)
+    {
+        std::function<void()> task {};
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            condition.wait(lock, [this] { return !running || !tasks.empty(); });
+            if (tasks.empty())
+                return;
+
+            task = std::move(tasks.front());
+            tasks.pop();
+        }
+        task();
+    }
+}
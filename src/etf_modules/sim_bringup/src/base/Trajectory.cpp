@@ -21,82 +21,281 @@ sim_bringup::Trajectory::Trajectory(const std::string &config_file_path) :
         trajectory_max_time_step = 0.1;
         RCLCPP_WARN(rclcpp::get_logger("rclcpp"), "Maximal edge length is not defined! Using default value of %f", trajectory_max_time_step);
     }
+
+    if (planner_node["trajectory_max_computing_time"].IsDefined())
+        trajectory_max_computing_time = planner_node["trajectory_max_computing_time"].as<float>();
+    else
+        trajectory_max_computing_time = 1.0;
+
+    if (planner_node["trajectory_tolerance"].IsDefined())
+        trajectory_tolerance = planner_node["trajectory_tolerance"].as<float>();
+    else
+        trajectory_tolerance = 0;
+
+    if (planner_node["trajectory_streaming_chunk"].IsDefined())
+        streaming_chunk = planner_node["trajectory_streaming_chunk"].as<float>();
+    else
+        streaming_chunk = 0;
+
+    streaming = false;
+    stream_idx = 0;
+    stream_time_published = 0;
+    chunk_msg.joint_names = msg.joint_names;
+    publish_pending = false;
+    publish_thread_running = false;
 }
 
-void sim_bringup::Trajectory::addPoint(float time_instance, const Eigen::VectorXf &position)
+sim_bringup::Trajectory::~Trajectory()
 {
-    trajectory_msgs::msg::JointTrajectoryPoint point {};
-    for (long int i = 0; i < position.size(); i++)
     {
-        point.positions.emplace_back(position(i));
-        point.velocities.emplace_back(0);
-        point.accelerations.emplace_back(0);
+        std::lock_guard<std::mutex> lock(publish_mutex);
+        publish_thread_running = false;
+        publish_pending = false;
     }
+    publish_condition.notify_one();
 
-    point.time_from_start.sec = int32_t(time_instance);
-    point.time_from_start.nanosec = (time_instance - point.time_from_start.sec) * 1e9;
-    msg.points.emplace_back(point);
+    if (publish_thread.joinable())
+        publish_thread.join();
 }
 
-void sim_bringup::Trajectory::addPoint(float time_instance, const Eigen::VectorXf &position, const Eigen::VectorXf &velocity)
+/// @brief Append a new point to 'msg.points', reusing a spare point (and its buffers) when available.
+/// Positions, velocities and accelerations of the returned point are sized to the number of DOFs, but not initialized.
+/// @param time_instance Time from start of the point in [s].
+/// @return Reference to the appended point.
+trajectory_msgs::msg::JointTrajectoryPoint &sim_bringup::Trajectory::newPoint(float time_instance)
 {
-    trajectory_msgs::msg::JointTrajectoryPoint point {};
-    for (long int i = 0; i < position.size(); i++)
+    if (spare_points.empty())
+        msg.points.emplace_back();
+    else
     {
-        point.positions.emplace_back(position(i));
-        point.velocities.emplace_back(velocity(i));
-        point.accelerations.emplace_back(0);
+        msg.points.emplace_back(std::move(spare_points.back()));
+        spare_points.pop_back();
     }
 
+    trajectory_msgs::msg::JointTrajectoryPoint &point { msg.points.back() };
+    point.positions.resize(Robot::getNumDOFs());
+    point.velocities.resize(Robot::getNumDOFs());
+    point.accelerations.resize(Robot::getNumDOFs());
     point.time_from_start.sec = int32_t(time_instance);
     point.time_from_start.nanosec = (time_instance - point.time_from_start.sec) * 1e9;
-    msg.points.emplace_back(point);
+    return point;
+}
+
+void sim_bringup::Trajectory::addPoint(float time_instance, const Eigen::VectorXf &position)
+{
+    trajectory_msgs::msg::JointTrajectoryPoint &point { newPoint(time_instance) };
+    dispatchNumDOFs(Robot::getNumDOFs(), [&](auto N)
+    {
+        constexpr int n { decltype(N)::value };
+        Eigen::Map<VectorNd<n>>(point.positions.data(), Robot::getNumDOFs()) = 
+            Eigen::Map<const VectorNf<n>>(position.data(), Robot::getNumDOFs()).template cast<double>();
+        Eigen::Map<VectorNd<n>>(point.velocities.data(), Robot::getNumDOFs()).setZero();
+        Eigen::Map<VectorNd<n>>(point.accelerations.data(), Robot::getNumDOFs()).setZero();
+    });
+}
+
+void sim_bringup::Trajectory::addPoint(float time_instance, const Eigen::VectorXf &position, const Eigen::VectorXf &velocity)
+{
+    trajectory_msgs::msg::JointTrajectoryPoint &point { newPoint(time_instance) };
+    dispatchNumDOFs(Robot::getNumDOFs(), [&](auto N)
+    {
+        constexpr int n { decltype(N)::value };
+        Eigen::Map<VectorNd<n>>(point.positions.data(), Robot::getNumDOFs()) = 
+            Eigen::Map<const VectorNf<n>>(position.data(), Robot::getNumDOFs()).template cast<double>();
+        Eigen::Map<VectorNd<n>>(point.velocities.data(), Robot::getNumDOFs()) = 
+            Eigen::Map<const VectorNf<n>>(velocity.data(), Robot::getNumDOFs()).template cast<double>();
+        Eigen::Map<VectorNd<n>>(point.accelerations.data(), Robot::getNumDOFs()).setZero();
+    });
 }
 
 void sim_bringup::Trajectory::addPoint(float time_instance, const Eigen::VectorXf &position, const Eigen::VectorXf &velocity, 
                                        const Eigen::VectorXf &acceleration)
 {
-    trajectory_msgs::msg::JointTrajectoryPoint point {};
-    for (long int i = 0; i < position.size(); i++)
+    trajectory_msgs::msg::JointTrajectoryPoint &point { newPoint(time_instance) };
+    dispatchNumDOFs(Robot::getNumDOFs(), [&](auto N)
     {
-        point.positions.emplace_back(position(i));
-        point.velocities.emplace_back(velocity(i));
-        point.accelerations.emplace_back(acceleration(i));
-    }
-
-    point.time_from_start.sec = int32_t(time_instance);
-    point.time_from_start.nanosec = (time_instance - point.time_from_start.sec) * 1e9;
-    msg.points.emplace_back(point);
+        constexpr int n { decltype(N)::value };
+        Eigen::Map<VectorNd<n>>(point.positions.data(), Robot::getNumDOFs()) = 
+            Eigen::Map<const VectorNf<n>>(position.data(), Robot::getNumDOFs()).template cast<double>();
+        Eigen::Map<VectorNd<n>>(point.velocities.data(), Robot::getNumDOFs()) = 
+            Eigen::Map<const VectorNf<n>>(velocity.data(), Robot::getNumDOFs()).template cast<double>();
+        Eigen::Map<VectorNd<n>>(point.accelerations.data(), Robot::getNumDOFs()) = 
+            Eigen::Map<const VectorNf<n>>(acceleration.data(), Robot::getNumDOFs()).template cast<double>();
+    });
 }
 
 /// @brief Add points from 'spline' to 'msg.points' using the time discretization step 'trajectory_max_time_step'.
+/// Quintic splines of a robot with 'NUM_DOFS_FIXED' DOFs are sampled in batches (see 'addPointsBatch'), 
+/// while the remaining points are sampled one by one.
+/// If 'trajectory_tolerance' is set, quintic splines are sampled adaptively instead (see 'addPointsAdaptive').
 /// @param spline Spline which points are used.
 /// @param t_offset Time offset for which all points are time shifted.
 /// @param t_final Final time from the spline which limits a final point that will be added.
 void sim_bringup::Trajectory::addPoints(std::shared_ptr<planning::trajectory::Spline> spline, float t_offset, float t_final)
 {
-    Eigen::VectorXf q_current {};
-    Eigen::VectorXf q_current_dot {};
-    Eigen::VectorXf q_current_ddot {};
-    float t { 0 };
+    if (trajectory_tolerance > 0 && addPointsAdaptive(spline, t_offset, t_final))
+        return;
 
-    do
+    const size_t num_points { std::max(size_t(std::ceil(t_final / trajectory_max_time_step)), size_t(1)) };
+    reserve(num_points);
+
+    size_t k { 1 };     // Point 'k' is at time min(k * trajectory_max_time_step, t_final)
+    if (std::dynamic_pointer_cast<planning::trajectory::Spline5>(spline) != nullptr)
+    {
+        k = dispatchNumDOFs(Robot::getNumDOFs(), [&](auto N) -> size_t
+        {
+            if constexpr (decltype(N)::value == Eigen::Dynamic)
+                return 1;
+            else
+                return addPointsBatch<decltype(N)::value>(spline, t_offset, t_final, num_points);
+        });
+    }
+
+    float t { 0 };
+    for (; k <= num_points; k++)
     {
-        t += trajectory_max_time_step;
-        if (t > t_final)
-            t = t_final;
-
-        q_current = spline->getPosition(t);
-        q_current_dot = spline->getVelocity(t);
-        q_current_ddot = spline->getAcceleration(t);
-        addPoint(t_offset + t, q_current, q_current_dot, q_current_ddot);
+        t = std::min(k * trajectory_max_time_step, t_final);
+        addPoint(t_offset + t, spline->getPosition(t), spline->getVelocity(t), spline->getAcceleration(t));
         
         // std::cout << "Adding point at time: " << t_offset + t << " [s] \n";
-        // std::cout << "Position:     " << q_current.transpose() << "\n";
-        // std::cout << "Velocity:     " << q_current_dot.transpose() << "\n";
-        // std::cout << "Acceleration: " << q_current_ddot.transpose() << "\n\n";
-    } 
+        // std::cout << "Position:     " << spline->getPosition(t).transpose() << "\n";
+        // std::cout << "Velocity:     " << spline->getVelocity(t).transpose() << "\n";
+        // std::cout << "Acceleration: " << spline->getAcceleration(t).transpose() << "\n\n";
+    }
+}
+
+/// @brief Add points from a quintic 'spline' using adaptive time steps, such that the controller's interpolation between 
+/// two consecutive points deviates from the spline by at most 'trajectory_tolerance' in each joint.
+/// Interpolation by a cubic Hermite polynomial (using positions and velocities) has the error bound h^4 / 384 * max|snap| 
+/// on the interval of length h, where the snap (derivative of the jerk) of a quintic is linear in time, 
+/// so its maximal absolute value is reached at one of the interval ends. The bound also holds when the controller uses 
+/// quintic interpolation (which is then exact). The step is computed from this bound, and limited to 
+/// ['trajectory_max_time_step', 'MAX_ADAPTIVE_TIME_STEP']. Since a joint may finish its motion before the others 
+/// (when its polynomial is no longer valid), the error is also checked at the middle of each step, and the step is halved if needed.
+/// @param spline Spline which points are used.
+/// @param t_offset Time offset for which all points are time shifted.
+/// @param t_final Final time from the spline which limits a final point that will be added.
+/// @return Whether the points are added (false if 'spline' is not quintic).
+bool sim_bringup::Trajectory::addPointsAdaptive(const std::shared_ptr<planning::trajectory::Spline> &spline, float t_offset, float t_final)
+{
+    if (std::dynamic_pointer_cast<planning::trajectory::Spline5>(spline) == nullptr)
+        return false;
+    
+    const Eigen::MatrixXf &coeff { spline->getCoeff() };    // Row 'i' contains coefficients of joint 'i' w.r.t. t^0, t^1, ..., t^5
+    if (coeff.rows() != long(Robot::getNumDOFs()) || coeff.cols() != 6)
+        return false;
+
+    const Eigen::VectorXf snap_slope { 120 * coeff.col(5) };
+    const Eigen::VectorXf snap_init { 24 * coeff.col(4) };    // snap(t) = snap_slope * t + snap_init
+    Eigen::VectorXf q_prev { spline->getPosition(0) };
+    Eigen::VectorXf q_prev_dot { spline->getVelocity(0) };
+    Eigen::VectorXf q_next {}, q_next_dot {}, q_mid {};
+    float t { 0 }, t_next {}, h {}, snap_max {};
+    const float h_max { std::max(trajectory_max_time_step, MAX_ADAPTIVE_TIME_STEP) };   // Not less than the min. step
+
+    do
+    {
+        // Conservative bound, since max|snap| on [t, t + h_max] is not less than on [t, t + h]
+        snap_max = std::max((snap_slope * t + snap_init).cwiseAbs().maxCoeff(), 
+                            (snap_slope * (t + h_max) + snap_init).cwiseAbs().maxCoeff());
+        h = snap_max > 0 ? std::pow(384 * trajectory_tolerance / snap_max, 0.25f) : h_max;
+        h = std::clamp(h, trajectory_max_time_step, h_max);
+        t_next = std::min(t + h, t_final);
+
+        while (true)
+        {
+            q_next = spline->getPosition(t_next);
+            q_next_dot = spline->getVelocity(t_next);
+            h = t_next - t;
+            if (h <= trajectory_max_time_step)
+                break;
+            
+            // Cubic Hermite interpolation at the middle of the step
+            q_mid = (q_prev + q_next) / 2 + h / 8 * (q_prev_dot - q_next_dot);
+            if ((q_mid - spline->getPosition(t + h / 2)).cwiseAbs().maxCoeff() <= trajectory_tolerance)
+                break;
+            
+            t_next = t + std::max(h / 2, trajectory_max_time_step);
+        }
+
+        addPoint(t_offset + t_next, q_next, q_next_dot, spline->getAcceleration(t_next));
+        t = t_next;
+        q_prev = q_next;
+        q_prev_dot = q_next_dot;
+    }
     while (t < t_final);
+
+    return true;
+}
+
+/// @brief Add points 1, 2, ... from a quintic 'spline' of an 'N'-DOF robot in batches of 'BATCH_SIZE' time instances.
+/// Position, velocity and acceleration of all joints are evaluated at once using Horner's scheme over fixed-size arrays, 
+/// so the computation is vectorized across time instances, and results are written directly into the message.
+/// Since a joint may finish its motion before the others (when its polynomial is no longer valid), the last point of each batch 
+/// is verified against 'spline->getPosition'. If they differ, the batch is discarded and the remaining points are left to the caller.
+/// @param spline Quintic spline which points are used.
+/// @param t_offset Time offset for which all points are time shifted.
+/// @param t_final Final time from the spline which limits a final point that will be added.
+/// @param num_points Total number of points to be added.
+/// @return Index of the first point that is not added.
+template <int N>
+size_t sim_bringup::Trajectory::addPointsBatch(const std::shared_ptr<planning::trajectory::Spline> &spline, float t_offset, 
+                                               float t_final, size_t num_points)
+{
+    typedef VectorNf<N> VectorN;
+    typedef Eigen::Array<float, N, BATCH_SIZE> ArrayNB;
+
+    const Eigen::MatrixXf &coeff { spline->getCoeff() };    // Row 'i' contains coefficients of joint 'i' w.r.t. t^0, t^1, ..., t^5
+    if (coeff.rows() != N || coeff.cols() != 6)
+        return 1;
+
+    // Coefficients of position, velocity and acceleration polynomials, where the highest order comes first
+    std::array<VectorN, 6> c_pos {};
+    std::array<VectorN, 5> c_vel {};
+    std::array<VectorN, 4> c_acc {};
+    for (size_t i = 0; i < 6; i++)
+        c_pos[i] = coeff.col(5 - i);
+    for (size_t i = 0; i < 5; i++)
+        c_vel[i] = (5 - i) * coeff.col(5 - i);
+    for (size_t i = 0; i < 4; i++)
+        c_acc[i] = (5 - i) * (4 - i) * coeff.col(5 - i);
+
+    Eigen::Array<float, 1, BATCH_SIZE> t {};
+    ArrayNB T {}, pos {}, vel {}, acc {};
+    size_t k { 1 };
+
+    for (; k + BATCH_SIZE - 1 <= num_points; k += BATCH_SIZE)
+    {
+        for (size_t j = 0; j < BATCH_SIZE; j++)
+            t(j) = std::min((k + j) * trajectory_max_time_step, t_final);
+        T = t.template replicate<N, 1>();
+
+        pos = c_pos[0].array().template replicate<1, BATCH_SIZE>();
+        for (size_t i = 1; i < 6; i++)
+            pos = pos * T + c_pos[i].array().template replicate<1, BATCH_SIZE>();
+
+        if (((pos.col(BATCH_SIZE-1).matrix() - spline->getPosition(t(BATCH_SIZE-1))).cwiseAbs().array() > 
+            1e-4 * (1 + pos.col(BATCH_SIZE-1).abs())).any())
+            break;
+
+        vel = c_vel[0].array().template replicate<1, BATCH_SIZE>();
+        for (size_t i = 1; i < 5; i++)
+            vel = vel * T + c_vel[i].array().template replicate<1, BATCH_SIZE>();
+
+        acc = c_acc[0].array().template replicate<1, BATCH_SIZE>();
+        for (size_t i = 1; i < 4; i++)
+            acc = acc * T + c_acc[i].array().template replicate<1, BATCH_SIZE>();
+
+        for (size_t j = 0; j < BATCH_SIZE; j++)
+        {
+            trajectory_msgs::msg::JointTrajectoryPoint &point { newPoint(t_offset + t(j)) };
+            Eigen::Map<VectorNd<N>>(point.positions.data()) = pos.col(j).cast<double>();
+            Eigen::Map<VectorNd<N>>(point.velocities.data()) = vel.col(j).cast<double>();
+            Eigen::Map<VectorNd<N>>(point.accelerations.data()) = acc.col(j).cast<double>();
+        }
+    }
+
+    return k;
 }
 
 void sim_bringup::Trajectory::addPath(const std::vector<std::shared_ptr<base::State>> &path, const std::vector<float> &time_instances)
@@ -187,6 +386,9 @@ void sim_bringup::Trajectory::addPath(const std::vector<std::shared_ptr<base::St
 /// Converting this path to trajectory (i.e., assigning time instances to these points) will be automatically done by this function.
 /// This is done by creating a sequence of quintic splines in a way that all constraints on robot's maximal velocity, 
 /// acceleration and jerk are surely always satisfied.
+/// Velocities at waypoints are first bounded by a forward and a backward pass over the whole path (see 'computeWaypointVelocities'),
+/// so each spline is computed at most 'max_num_iter' + 1 times, and the total runtime is linear in the path size.
+/// If some spline cannot be computed, or 'trajectory_max_computing_time' is exceeded, the first method is used instead.
 /// @param path Path containing all points that robot (must) visit.
 /// @param must_visit Whether path points must be visited.
 /// @note Be careful since the distance between each two adjacent points from 'path' should not be too long! 
@@ -194,102 +396,73 @@ void sim_bringup::Trajectory::addPath(const std::vector<std::shared_ptr<base::St
 /// Consider using 'preprocessPath' function from 'Planner' class before using this function.
 void sim_bringup::Trajectory::addPath(const std::vector<std::shared_ptr<base::State>> &path, bool must_visit)
 {
-    std::vector<std::shared_ptr<planning::trajectory::Spline>> splines(path.size(), nullptr);
-    bool found { false };
-    size_t num_iter {};
-    size_t max_num_iter { 5 };
-    float delta_t_max {};
-    Eigen::VectorXf q_final_dot_max {};
-    Eigen::VectorXf q_final_dot_min {};
-    Eigen::VectorXf q_final_dot {};
-    Eigen::VectorXf q_final {};
-    std::vector<float> vel_coeff(path.size(), 1.0);
-    const float vel_coeff_const { 0.9 };
-    auto time_start = std::chrono::steady_clock::now();
-    float max_time { 1.0 };
+    auto time_start { std::chrono::steady_clock::now() };
+    if (path.size() < 2)
+    {
+        if (!path.empty())
+            addPoint(0, path.front()->getCoord());
+        return;
+    }
+
+    // Waypoints which are reached by the splines
+    std::vector<Eigen::VectorXf> waypoints(path.size());
+    waypoints.front() = path.front()->getCoord();
+    waypoints.back() = path.back()->getCoord();
+    for (size_t i = 1; i < path.size() - 1; i++)
+    {
+        if (!must_visit)
+            waypoints[i] = (path[i-1]->getCoord() + path[i]->getCoord()) / 2;
+        else
+            waypoints[i] = path[i]->getCoord();
+    }
+
+    std::vector<Eigen::VectorXf> velocities {};
+    computeWaypointVelocities(waypoints, velocities);
 
+    std::vector<std::shared_ptr<planning::trajectory::Spline>> splines(waypoints.size(), nullptr);
     splines.front() = std::make_shared<planning::trajectory::Spline5>
     (
         Robot::getRobot(), 
-        path.front()->getCoord(), 
+        waypoints.front(), 
         Eigen::VectorXf::Zero(Robot::getNumDOFs()), 
         Eigen::VectorXf::Zero(Robot::getNumDOFs())
     );
-    
-    for (size_t i = 1; i < path.size(); i++)
-    {
-        splines[i] = std::make_shared<planning::trajectory::Spline5>
-        (
-            Robot::getRobot(), 
-            splines[i-1]->getPosition(splines[i-1]->getTimeFinal()), 
-            splines[i-1]->getVelocity(splines[i-1]->getTimeFinal()), 
-            splines[i-1]->getAcceleration(splines[i-1]->getTimeFinal())
-        );
-
-        if (i == path.size() - 1)   // Final configuration will be reached, thus final velocity and acceleration must be zero!
-        {
-            found = splines[i]->compute(path.back()->getCoord());
-            if (!found) 
-            {
-                // std::cout << "Not found! \n";
-                vel_coeff[--i] *= vel_coeff_const;
-                --i;
-            }
-            else
-                break;
-        }
 
-        if (!must_visit)
-            q_final = (path[i-1]->getCoord() + path[i]->getCoord()) / 2;
-        else
-            q_final = path[i]->getCoord();
+    const size_t max_num_iter { 5 };
+    const float vel_coeff_const { 0.5 };
+    bool found { true };
+    size_t num_computations { 0 };
+
+    for (size_t i = 1; i < waypoints.size() && found; i++)
+    {
+        const float t_final_prev { splines[i-1]->getTimeFinal() };
+        const Eigen::VectorXf q_init { splines[i-1]->getPosition(t_final_prev) };
+        const Eigen::VectorXf q_init_dot { splines[i-1]->getVelocity(t_final_prev) };
+        const Eigen::VectorXf q_init_ddot { splines[i-1]->getAcceleration(t_final_prev) };
         
+        // Final velocity is decreased until the spline is found. Zero final velocity is tried the last.
         found = false;
-        num_iter = 0;
-        delta_t_max = ((q_final - path[i-1]->getCoord()).cwiseQuotient(Robot::getMaxVel())).cwiseAbs().maxCoeff();
-        q_final_dot_max = (q_final - path[i-1]->getCoord()) / delta_t_max;
-        q_final_dot_min = Eigen::VectorXf::Zero(Robot::getNumDOFs());
-
-        do
-        {
-            q_final_dot = vel_coeff[i] * (q_final_dot_max + q_final_dot_min) / 2;
-            std::shared_ptr<planning::trajectory::Spline> spline_new {
-                std::make_shared<planning::trajectory::Spline5>
-                (
-                    Robot::getRobot(), 
-                    splines[i-1]->getPosition(splines[i-1]->getTimeFinal()), 
-                    splines[i-1]->getVelocity(splines[i-1]->getTimeFinal()), 
-                    splines[i-1]->getAcceleration(splines[i-1]->getTimeFinal())
-                )
-            };
-            
-            if (spline_new->compute(q_final, q_final_dot)) 
-            {
-                *splines[i] = *spline_new;
-                q_final_dot_min = q_final_dot;
-                found = true;
-            }
-            else
-                q_final_dot_max = q_final_dot;
-        }
-        while (++num_iter < max_num_iter);
-
-        if (!found)
+        float vel_coeff { 1.0 };
+        for (size_t num_iter = 0; num_iter <= max_num_iter && !found; num_iter++)
         {
-            found = splines[i]->compute(q_final);
-            if (!found)
+            splines[i] = std::make_shared<planning::trajectory::Spline5>(Robot::getRobot(), q_init, q_init_dot, q_init_ddot);
+            num_computations++;
+            if (num_iter == max_num_iter || velocities[i].isZero())
             {
-                // std::cout << "Not found! \n";
-                vel_coeff[--i] *= vel_coeff_const;
-                --i;
+                found = splines[i]->compute(waypoints[i]);
+                break;
             }
-            // else std::cout << "Found with zero final velocity! \n";
+            
+            found = splines[i]->compute(waypoints[i], vel_coeff * velocities[i]);
+            vel_coeff *= vel_coeff_const;
         }
 
-        if (std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - time_start).count() * 1e-3 > max_time)
+        if (std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - time_start).count() * 1e-6 
+            > trajectory_max_computing_time)
         {
+            RCLCPP_WARN(rclcpp::get_logger("rclcpp"), "Time limit of %f [s] for computing trajectory is exceeded!", 
+                trajectory_max_computing_time);
             found = false;
-            break;
         }
     }
 
@@ -297,20 +470,131 @@ void sim_bringup::Trajectory::addPath(const std::vector<std::shared_ptr<base::St
     {
         float t_current { 0 };
         addPoint(t_current, path.front()->getCoord());
-        for (size_t i = 1; i < path.size(); i++)
+        for (size_t i = 1; i < splines.size(); i++)
         {
             addPoints(splines[i], t_current, splines[i]->getTimeFinal());
             t_current += splines[i]->getTimeFinal();
             // std::cout << "t_current: " << t_current << " [s] \n";
         }
+        RCLCPP_INFO(rclcpp::get_logger("rclcpp"), "Trajectory of duration %f [s] is computed in %f [ms] (%ld splines, %ld computations).", 
+            t_current, std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - time_start).count() * 1e-3,
+            splines.size() - 1, num_computations);
     }
     else
+    {
+        RCLCPP_WARN(rclcpp::get_logger("rclcpp"), "Trajectory cannot be computed through the waypoints. Using another method...");
         addPath(path);      // Add path using another method.
+    }
+}
+
+/// @brief Compute velocities at 'waypoints', which are then used as final velocities of the splines.
+/// At each interior waypoint, the velocity is directed along the central difference of its neighbours, 
+/// and scaled so that the fastest joint moves with its maximal velocity. The scale is then reduced:
+/// (1) at corners, proportionally to the cosine of the angle between incoming and outgoing segments;
+/// (2) by a forward pass, so that the velocity is reachable from the previous one within the segment length;
+/// (3) by a backward pass, so that the robot can still slow down to the next one (and finally stop at the last waypoint).
+/// Passes (2) and (3) use a half of maximal acceleration of each joint as a margin for the jerk limits.
+/// @param waypoints Waypoints (the first and the last have zero velocity).
+/// @param velocities Computed velocities (output).
+void sim_bringup::Trajectory::computeWaypointVelocities(const std::vector<Eigen::VectorXf> &waypoints, 
+                                                        std::vector<Eigen::VectorXf> &velocities)
+{
+    const size_t n { waypoints.size() };
+    const Eigen::VectorXf acc_max { 0.5 * Robot::getMaxAcc() };
+    velocities.assign(n, Eigen::VectorXf::Zero(Robot::getNumDOFs()));
+    std::vector<float> scale(n, 0);
+    Eigen::VectorXf dir {}, delta_prev {}, delta_next {};
+
+    for (size_t i = 1; i < n - 1; i++)
+    {
+        delta_prev = waypoints[i] - waypoints[i-1];
+        delta_next = waypoints[i+1] - waypoints[i];
+        dir = waypoints[i+1] - waypoints[i-1];
+        float dir_max { dir.cwiseQuotient(Robot::getMaxVel()).cwiseAbs().maxCoeff() };
+        if (dir_max < 1e-6 || delta_prev.norm() < 1e-6 || delta_next.norm() < 1e-6)
+            continue;
+
+        velocities[i] = dir / dir_max;
+        scale[i] = std::max(delta_prev.normalized().dot(delta_next.normalized()), 0.0f);
+    }
+
+    // Max. scale of velocity at waypoint 'j' w.r.t. the velocity at its neighbour 'k'
+    auto reachableScale = [&](size_t j, size_t k) -> float
+    {
+        float scale_max { scale[j] };
+        for (size_t m = 0; m < Robot::getNumDOFs(); m++)
+        {
+            if (std::abs(velocities[j](m)) < 1e-6)
+                continue;
+            float v_k { scale[k] * std::abs(velocities[k](m)) };
+            float v_max { std::sqrt(v_k * v_k + 2 * acc_max(m) * std::abs(waypoints[j](m) - waypoints[k](m))) };
+            scale_max = std::min(scale_max, v_max / std::abs(velocities[j](m)));
+        }
+        return scale_max;
+    };
+
+    for (size_t i = 1; i < n - 1; i++)         // Forward pass
+        scale[i] = reachableScale(i, i-1);
+    
+    for (size_t i = n - 2; i > 0; i--)         // Backward pass
+        scale[i] = reachableScale(i, i+1);
+
+    for (size_t i = 1; i < n - 1; i++)
+        velocities[i] *= scale[i];
 }
 
 /// @brief Publish a trajectory stored in 'msg.points'.
 /// @param print Whether to print a published trajectory points. Default: false.
 void sim_bringup::Trajectory::publish(bool print)
+{
+    std::lock_guard<std::mutex> lock(publish_mutex);
+    publish_pending = false;
+    publishTrajectory(print);
+}
+
+/// @brief Publish a trajectory stored in 'msg.points' at 'release_time', and return immediately.
+/// Until then (or until 'clear()', which cancels the publish), 'msg.points' must not be modified.
+/// @param release_time Absolute time when the trajectory is published. If it is in the past, the trajectory is published right away.
+void sim_bringup::Trajectory::publishAt(std::chrono::steady_clock::time_point release_time)
+{
+    {
+        std::lock_guard<std::mutex> lock(publish_mutex);
+        if (!publish_thread_running)    // The thread is started on the first use only
+        {
+            publish_thread_running = true;
+            publish_thread = std::thread(&Trajectory::publishingThread, this);
+        }
+        publish_release_time = release_time;
+        publish_pending = true;
+    }
+    publish_condition.notify_one();
+}
+
+void sim_bringup::Trajectory::publishingThread()
+{
+    std::unique_lock<std::mutex> lock(publish_mutex);
+    while (publish_thread_running)
+    {
+        if (!publish_pending)
+        {
+            publish_condition.wait(lock);
+            continue;
+        }
+
+        // Woken up earlier if the publish is cancelled or rescheduled
+        if (publish_condition.wait_until(lock, publish_release_time) == std::cv_status::no_timeout)
+            continue;
+        
+        if (publish_pending && std::chrono::steady_clock::now() >= publish_release_time)
+        {
+            publish_pending = false;
+            publishTrajectory(false);
+        }
+    }
+}
+
+// Must be called while holding 'publish_mutex'
+void sim_bringup::Trajectory::publishTrajectory(bool print)
 {
     if (msg.points.empty())
     {
@@ -318,7 +602,20 @@ void sim_bringup::Trajectory::publish(bool print)
         return;
     }
 
-    publisher->publish(msg);
+    // Long trajectories are streamed in chunks, so the robot starts moving after the first (small) chunk is received
+    if (streaming_chunk > 0 && clock != nullptr && toSeconds(msg.points.back().time_from_start) > 2 * streaming_chunk)
+    {
+        streaming = true;
+        stream_idx = 0;
+        stream_time_start = clock->now();
+        stream_time_published = 0;
+        publishChunk();
+    }
+    else
+    {
+        streaming = false;
+        publisher->publish(msg);
+    }
 
     if (!print)
         return;
@@ -362,7 +659,120 @@ void sim_bringup::Trajectory::publish(bool print)
     RCLCPP_INFO(rclcpp::get_logger("rclcpp"), "Publishing trajectory ...");
 }
 
+/// @brief Publish the next chunk of the streamed trajectory. The chunk is not scheduled by a future 'header.stamp', 
+/// since the controller starts executing a received trajectory from its current state and drops the points which are already stale. 
+/// Instead, the chunk starts with the trajectory sampled at the current time, followed by the points from the next 
+/// 2 * 'streaming_chunk' [s]. Since the next chunk is published while 'streaming_chunk' [s] of the previous one still remains, 
+/// consecutive chunks overlap, and the robot does not stop between them.
+void sim_bringup::Trajectory::publishChunk()
+{
+    float t_now { float((clock->now() - stream_time_start).seconds()) };
+    if (t_now > stream_time_published)  // The previous chunk is already executed, so the robot waits at its last point
+    {
+        stream_time_start = clock->now() - rclcpp::Duration::from_seconds(stream_time_published);
+        t_now = stream_time_published;
+    }
+
+    while (stream_idx < msg.points.size() && toSeconds(msg.points[stream_idx].time_from_start) <= t_now)
+        stream_idx++;
+    
+    if (stream_idx == msg.points.size())
+    {
+        streaming = false;
+        return;
+    }
+
+    size_t idx_last { stream_idx + 1 };
+    while (idx_last < msg.points.size() && toSeconds(msg.points[idx_last].time_from_start) <= t_now + 2 * streaming_chunk)
+        idx_last++;
+    
+    const size_t num_sampled { stream_idx > 0 ? size_t(1) : size_t(0) };
+    chunk_msg.header.stamp = builtin_interfaces::msg::Time();   // Zero stamp means that the chunk is executed upon its receipt
+    chunk_msg.points.resize(num_sampled + idx_last - stream_idx);
+    if (num_sampled > 0)
+        samplePoint(msg.points[stream_idx - 1], msg.points[stream_idx], t_now, chunk_msg.points.front());
+
+    for (size_t i = num_sampled; i < chunk_msg.points.size(); i++)
+    {
+        trajectory_msgs::msg::JointTrajectoryPoint &point { chunk_msg.points[i] };
+        point = msg.points[stream_idx - num_sampled + i];   // Buffers of 'point' are reused
+        point.time_from_start = rclcpp::Duration::from_seconds(toSeconds(point.time_from_start) - t_now);
+    }
+    publisher->publish(chunk_msg);
+
+    stream_time_published = toSeconds(msg.points[idx_last - 1].time_from_start);
+    if (idx_last == msg.points.size())
+        streaming = false;
+    
+    RCLCPP_DEBUG(rclcpp::get_logger("rclcpp"), "Published trajectory chunk of %ld points starting at %f [s].", 
+        chunk_msg.points.size(), t_now);
+}
+
+// Sample the trajectory at 'time_instance' between two consecutive points 'point0' and 'point1'. 
+// Positions are interpolated by a cubic Hermite polynomial (if velocities are given), and velocities and accelerations linearly.
+// The sampled point is stored in 'point' with zero 'time_from_start'.
+void sim_bringup::Trajectory::samplePoint(const trajectory_msgs::msg::JointTrajectoryPoint &point0, 
+    const trajectory_msgs::msg::JointTrajectoryPoint &point1, float time_instance, trajectory_msgs::msg::JointTrajectoryPoint &point)
+{
+    const float t0 { toSeconds(point0.time_from_start) };
+    const float dt { toSeconds(point1.time_from_start) - t0 };
+    const float s { dt > 0 ? std::clamp((time_instance - t0) / dt, 0.f, 1.f) : 1.f };
+    const bool hermite { point0.velocities.size() == point0.positions.size() && point1.velocities.size() == point1.positions.size() };
+
+    point = point0;     // Buffers of 'point' are reused
+    for (size_t k = 0; k < point.positions.size(); k++)
+    {
+        if (hermite)
+            point.positions[k] = (2*s*s*s - 3*s*s + 1) * point0.positions[k] + (s*s*s - 2*s*s + s) * dt * point0.velocities[k] +
+                                 (-2*s*s*s + 3*s*s) * point1.positions[k] + (s*s*s - s*s) * dt * point1.velocities[k];
+        else
+            point.positions[k] = (1 - s) * point0.positions[k] + s * point1.positions[k];
+    }
+    
+    for (size_t k = 0; k < point.velocities.size() && k < point1.velocities.size(); k++)
+        point.velocities[k] = (1 - s) * point0.velocities[k] + s * point1.velocities[k];
+    
+    for (size_t k = 0; k < point.accelerations.size() && k < point1.accelerations.size(); k++)
+        point.accelerations[k] = (1 - s) * point0.accelerations[k] + s * point1.accelerations[k];
+    
+    point.time_from_start = builtin_interfaces::msg::Duration();
+}
+
+// Publish the next chunk when less than 'streaming_chunk' of the already published trajectory remains to be executed
+void sim_bringup::Trajectory::streamingCallback()
+{
+    std::lock_guard<std::mutex> lock(publish_mutex);
+    if (!streaming)
+        return;
+
+    if ((clock->now() - stream_time_start).seconds() >= stream_time_published - streaming_chunk)
+        publishChunk();
+}
+
+// Points are moved to 'spare_points', so their buffers are reused when building the next trajectory.
+// Streaming of the previous trajectory (if any) is stopped, and its pending publish (if any) is cancelled.
 void sim_bringup::Trajectory::clear()
 {
+    std::lock_guard<std::mutex> lock(publish_mutex);
+    streaming = false;
+    if (publish_pending)
+    {
+        publish_pending = false;
+        publish_condition.notify_one();
+    }
+
+    spare_points.reserve(spare_points.size() + msg.points.size());
+    for (trajectory_msgs::msg::JointTrajectoryPoint &point : msg.points)
+        spare_points.emplace_back(std::move(point));
+    
     msg.points.clear();
 }
+
+/// @brief Reserve space for additional 'num_points' trajectory points, so that adding them does not reallocate 'msg.points'.
+/// @param num_points Number of points that will be added.
+void sim_bringup::Trajectory::reserve(size_t num_points)
+{
+    size_t capacity { msg.points.size() + num_points };
+    if (capacity > msg.points.capacity())
+        msg.points.reserve(std::max(capacity, 2 * msg.points.capacity()));   // Geometric growth when called repeatedly
+}
@@ -1,6 +1,9 @@
 #include "environments/AABB.h"
 
-sim_bringup::AABB::AABB(const std::string &config_file_path)
+#include <algorithm>
+
+sim_bringup::AABB::AABB(const std::string &config_file_path) :
+    obstacles_latency(1, 200)
 {
     std::string project_abs_path(__FILE__);
     for (size_t i = 0; i < 4; i++)
@@ -9,6 +12,21 @@ sim_bringup::AABB::AABB(const std::string &config_file_path)
     YAML::Node node { YAML::LoadFile(project_abs_path + config_file_path) };
     min_num_captures = node["cameras"]["min_num_captures"].as<size_t>();
 
+    max_obstacle_vel = 2.0;
+    YAML::Node max_obstacle_vel_node { node["cameras"]["max_obstacle_vel"] };
+    if (max_obstacle_vel_node.IsDefined())
+        max_obstacle_vel = max_obstacle_vel_node.as<float>();
+
+    prediction_horizon = 0;
+    latency_compensation = false;
+    max_latency_compensation = 0.5;
+    YAML::Node max_latency_compensation_node { node["cameras"]["max_latency_compensation"] };
+    if (max_latency_compensation_node.IsDefined())
+        max_latency_compensation = max_latency_compensation_node.as<float>();
+
+    clock = nullptr;
+    time_capture = 0;
+    time_capture_prev = 0;
     ready = false;
 }
 
@@ -32,12 +50,14 @@ void sim_bringup::AABB::callback(const sensor_msgs::msg::PointCloud2::SharedPtr
         // RCLCPP_INFO(rclcpp::get_logger("rclcpp"), "AABB %ld: dim = (%f, %f, %f), pos = (%f, %f, %f)",  // (x, y, z) in [m]
         //     i/2, dim.x(), dim.y(), dim.z(), pos.x(), pos.y(), pos.z());
     }
+    estimateVelocities(getCaptureTime(msg));
     ready = true;
 }
 
 void sim_bringup::AABB::withFilteringCallback(const sensor_msgs::msg::PointCloud2::SharedPtr msg)
 {
     ready = false;
+    time_capture = getCaptureTime(msg);
     pcl::PointCloud<pcl::PointXYZ>::Ptr pcl(new pcl::PointCloud<pcl::PointXYZ>);	
     pcl::moveFromROSMsg(*msg, *pcl);
     Eigen::Vector3f dim {};
@@ -72,17 +92,92 @@ void sim_bringup::AABB::withFilteringCallback(const sensor_msgs::msg::PointCloud
         {
             dimensions.emplace_back(dim);
             positions.emplace_back(pos);
+            velocities.emplace_back(Eigen::Vector3f::Zero());  // Averaged obstacles are considered as static
             num_captures.emplace_back(1);
         }                
     }
     ready = true;
 }
 
+/// @brief Get the time in [s] when the capture from 'msg' is taken, i.e., its header stamp.
+/// If the message is not stamped, the current time is used (i.e., it is considered as fresh).
+double sim_bringup::AABB::getCaptureTime(const sensor_msgs::msg::PointCloud2::SharedPtr &msg)
+{
+    rclcpp::Time time_stamp { msg->header.stamp, RCL_ROS_TIME };
+    if (time_stamp.nanoseconds() == 0 && clock != nullptr)
+        return clock->now().seconds();
+    
+    return time_stamp.seconds();
+}
+
 bool sim_bringup::AABB::whetherToRemove([[maybe_unused]] const Eigen::Vector3f &object_pos, [[maybe_unused]] const Eigen::Vector3f &object_dim)
 {    
     return false;
 }
 
+/// @brief Estimate the velocity of each obstacle from the current capture by associating it with the nearest obstacle 
+/// (of similar dimensions) from the previous capture. Obstacles without a match are considered as static.
+/// The estimate is averaged with the previous one of the matched obstacle to suppress the measurement noise.
+/// @param time_capture_ Time in [s] when the current capture is taken.
+void sim_bringup::AABB::estimateVelocities(double time_capture_)
+{
+    time_capture = time_capture_;
+    float delta_t { float(time_capture - time_capture_prev) };
+    velocities.assign(positions.size(), Eigen::Vector3f::Zero());
+
+    if (delta_t > 0)
+    {
+        for (size_t i = 0; i < positions.size(); i++)
+        {
+            float d_min { max_obstacle_vel * delta_t + 0.01f };     // 1 [cm] is tolerance for the measurement noise
+            int idx { -1 };
+            for (size_t j = 0; j < positions_prev.size(); j++)
+            {
+                float d { (positions[i] - positions_prev[j]).norm() };
+                if (d < d_min && (dimensions[i] - dimensions_prev[j]).norm() < 0.05)
+                {
+                    d_min = d;
+                    idx = j;
+                }
+            }
+
+            if (idx != -1)
+                velocities[i] = 0.5 * ((positions[i] - positions_prev[idx]) / delta_t + velocities_prev[idx]);
+        }
+    }
+
+    dimensions_prev = dimensions;
+    positions_prev = positions;
+    velocities_prev = velocities;
+    time_capture_prev = time_capture;
+}
+
+// Set velocities of obstacles from an external source (e.g., when they are known in advance), instead of estimating them
+void sim_bringup::AABB::setVelocities(const std::vector<Eigen::Vector3f> &velocities_)
+{
+    if (velocities_.size() != positions.size())
+    {
+        RCLCPP_WARN(rclcpp::get_logger("rclcpp"), "Number of velocities (%ld) does not match the number of obstacles (%ld)!", 
+            velocities_.size(), positions.size());
+        return;
+    }
+    velocities = velocities_;
+    velocities_prev = velocities_;
+}
+
+/// @brief Compute the box which is swept by the obstacle 'idx' moving with constant velocity during 'horizon', 
+/// which starts 'delay' after the capture.
+/// @param idx Obstacle index.
+/// @param delay Time in [s] from the capture until the horizon starts.
+/// @param horizon Time horizon in [s].
+/// @param dim Dimensions of the swept box (output).
+/// @param pos Position of the swept box center (output).
+void sim_bringup::AABB::computeSweptBox(size_t idx, float delay, float horizon, Eigen::Vector3f &dim, Eigen::Vector3f &pos) const
+{
+    pos = positions[idx] + velocities[idx] * (delay + horizon / 2);
+    dim = dimensions[idx] + velocities[idx].cwiseAbs() * horizon;
+}
+
 void sim_bringup::AABB::updateEnvironment()
 {
     if (!ready)
@@ -91,27 +186,46 @@ void sim_bringup::AABB::updateEnvironment()
         return;
     }
     
-    RCLCPP_INFO(rclcpp::get_logger("rclcpp"), "Updating environment..."); 
+    FAST_LOG_INFO("Updating environment...");
     env->removeObjects("table", false);
+
+    // Obstacles are captured in the past, so they are moved (using their velocities) to where they are now
+    float delay { 0 };
+    if (clock != nullptr && time_capture > 0)
+    {
+        float age { float(clock->now().seconds() - time_capture) };
+        obstacles_latency.add(age * 1e3);
+        FAST_LOG_DEBUG("Age of obstacles capture: %f [ms].", age * 1e3);
+        if (latency_compensation)
+            delay = std::clamp(age, 0.0f, max_latency_compensation);
+    }
     
+    Eigen::Vector3f dim {}, pos {};
     for (size_t i = 0; i < positions.size(); i++)
     {
         if (num_captures[i] >= min_num_captures)
         {
+            if (prediction_horizon > 0 || delay > 0)    // Obstacle is replaced by the box it sweeps during the prediction horizon
+                computeSweptBox(i, delay, prediction_horizon, dim, pos);
+            else
+            {
+                dim = dimensions[i];
+                pos = positions[i];
+            }
 		    std::shared_ptr<env::Object> object = 
-                std::make_shared<env::Box>(dimensions[i], positions[i], fcl::Quaternionf::Identity(), "dynamic_obstacle");
+                std::make_shared<env::Box>(dim, pos, fcl::Quaternionf::Identity(), "dynamic_obstacle");
             env->addObject(object);
 
-            RCLCPP_INFO(rclcpp::get_logger("rclcpp"), "AABB %ld: dim = (%f, %f, %f), pos = (%f, %f, %f), num. captures = %ld",
-                i, dimensions[i].x(), dimensions[i].y(), dimensions[i].z(),                 // (x, y, z) in [m]
-                positions[i].x(), positions[i].y(), positions[i].z(), num_captures[i]);     // (x, y, z) in [m]
+            FAST_LOG_DEBUG("AABB %ld: dim = (%f, %f, %f), pos = (%f, %f, %f), num. captures = %ld",
+                i, dim.x(), dim.y(), dim.z(),                                               // (x, y, z) in [m]
+                pos.x(), pos.y(), pos.z(), num_captures[i]);                                // (x, y, z) in [m]
         }
     }
 
     if (min_num_captures > 1)
         resetMeasurements();
     
-    RCLCPP_INFO(rclcpp::get_logger("rclcpp"), "Environment is updated."); 
+    FAST_LOG_INFO("Environment is updated.");
 }
 
 // Clear previous averaged measurements and start taking new ones
@@ -119,5 +233,6 @@ void sim_bringup::AABB::resetMeasurements()
 {
     dimensions.clear();
     positions.clear();
+    velocities.clear();
     num_captures.clear();
 }
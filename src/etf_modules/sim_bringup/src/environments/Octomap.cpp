@@ -6,7 +6,38 @@ sim_bringup::Octomap::Octomap(const std::string config_file_path)
     for (size_t i = 0; i < 4; i++)
         project_abs_path = project_abs_path.substr(0, project_abs_path.find_last_of("/\\"));
 
-    YAML::Node node { YAML::LoadFile(project_abs_path + config_file_path) };
+    octomap_octree = nullptr;
+    octree = nullptr;
+    streaming = false;
+    octomap_topic = "/octomap_binary";
+    num_updates = 0;
+    updates_held = false;
+    pending_octree = nullptr;
+    num_updates_visualized = 0;
+    num_subscribers = 0;
+    visualization_rate = 1;
+    visualization_topic = "/octree_vis_array";
+
+    try
+    {
+        YAML::Node node { YAML::LoadFile(project_abs_path + config_file_path) };
+        YAML::Node octomap_node { node["octomap"] };
+        if (octomap_node.IsDefined())
+        {
+            if (octomap_node["streaming"].IsDefined())
+                streaming = octomap_node["streaming"].as<bool>();
+            if (octomap_node["topic"].IsDefined())
+                octomap_topic = octomap_node["topic"].as<std::string>();
+            if (octomap_node["visualization_rate"].IsDefined())
+                visualization_rate = octomap_node["visualization_rate"].as<float>();
+            if (octomap_node["visualization_topic"].IsDefined())
+                visualization_topic = octomap_node["visualization_topic"].as<std::string>();
+        }
+    }
+    catch (std::exception &e)
+    {
+        RCLCPP_WARN(rclcpp::get_logger("rclcpp"), "Octomap configuration is not read (%s). Using the service '/octomap_binary'.", e.what());
+    }
 
     read_node = rclcpp::Node::make_shared("read_node");
     client = read_node->create_client<octomap_msgs::srv::GetOctomap>("/octomap_binary");
@@ -29,51 +60,150 @@ void sim_bringup::Octomap::read()
     auto result { client->async_send_request(request) };
     if (rclcpp::spin_until_future_complete(read_node, result) == rclcpp::FutureReturnCode::SUCCESS)
     {
-        octomap_msgs::msg::Octomap octomap_msg { result.get()->map };
-        octomap::AbstractOcTree* octomap_abstract_octree { octomap_msgs::binaryMsgToMap(octomap_msg) };
-        octomap_octree = dynamic_cast<octomap::OcTree*>(octomap_abstract_octree);
-
-        fcl::OcTreef Octree(std::make_shared<const octomap::OcTree>(*octomap_octree));
-        octree = std::make_shared<fcl::OcTreef>(Octree);            
-        
-        RCLCPP_INFO(rclcpp::get_logger("rclcpp"), "Octree read successfully!");
-        visualize();
+        std::shared_ptr<octomap::OcTree> octomap_octree_new { deserialize(result.get()->map) };
+        if (octomap_octree_new != nullptr)
+        {
+            {
+                std::lock_guard<std::mutex> lock(octree_mutex);
+                update(octomap_octree_new);
+            }
+            RCLCPP_INFO(rclcpp::get_logger("rclcpp"), "Octree read successfully!");
+            visualize();
+        }
     }
     else
         RCLCPP_ERROR(rclcpp::get_logger("rclcpp"), "Failed to read octree!");
 }
 
+/// @brief Deserialise 'octomap_msg' into a new tree. It does not touch the persistent tree, so it may run in any thread.
+/// @param octomap_msg Received octomap message (binary or full).
+/// @return The new tree, or nullptr if the message is not an occupancy octree.
+std::shared_ptr<octomap::OcTree> sim_bringup::Octomap::deserialize(const octomap_msgs::msg::Octomap &octomap_msg)
+{
+    std::unique_ptr<octomap::AbstractOcTree> octomap_abstract_octree { octomap_msgs::msgToMap(octomap_msg) };
+    if (dynamic_cast<octomap::OcTree*>(octomap_abstract_octree.get()) == nullptr)
+    {
+        RCLCPP_ERROR(rclcpp::get_logger("rclcpp"), "Received octomap is not an occupancy octree!");
+        return nullptr;
+    }
+
+    return std::shared_ptr<octomap::OcTree>(static_cast<octomap::OcTree*>(octomap_abstract_octree.release()));
+}
+
+// Apply a tree received from 'octomap_topic' (and deserialised) to the persistent tree. Only the latest one is kept while it is pending.
+void sim_bringup::Octomap::octreeCallback(const std::shared_ptr<octomap::OcTree> octomap_octree_new)
+{
+    pending_octree = octomap_octree_new;
+    applyPendingUpdate();
+}
+
+/// @brief Apply the pending tree (if any), unless updates are held. If 'visualize' is just reading the octree, 
+/// the caller does not wait, and the tree stays pending until the next call (e.g., from 'BaseNode::updateOctree').
+void sim_bringup::Octomap::applyPendingUpdate()
+{
+    if (updates_held || pending_octree == nullptr)
+        return;
+    
+    std::unique_lock<std::mutex> lock(octree_mutex, std::try_to_lock);
+    if (!lock.owns_lock())
+        return;
+
+    update(pending_octree);
+    pending_octree = nullptr;
+    RCLCPP_DEBUG(rclcpp::get_logger("rclcpp"), "Octree is updated (update num. %ld).", num_updates.load());
+}
+
+/// @brief Postpone applying received updates, since the octree is modified in place while it may be read by another thread
+/// (e.g., by a planner running in the background). Must be called from the same thread as 'octreeCallback'.
+void sim_bringup::Octomap::holdUpdates()
+{
+    updates_held = true;
+}
+
+/// @brief Apply the latest update received while updates were held (if any), and apply further updates as they arrive.
+void sim_bringup::Octomap::resumeUpdates()
+{
+    updates_held = false;
+    applyPendingUpdate();
+}
+
+// Must be called while holding 'octree_mutex'. The new content is swapped into the persistent tree 'octomap_octree', 
+// so the FCL wrapper 'octree' is created only once (or again when the resolution changes), and all previously obtained 
+// pointers to it remain valid.
+void sim_bringup::Octomap::update(const std::shared_ptr<octomap::OcTree> &octomap_octree_new)
+{
+    if (octomap_octree == nullptr || octomap_octree->getResolution() != octomap_octree_new->getResolution())
+    {
+        octomap_octree = octomap_octree_new;
+        octree = std::make_shared<fcl::OcTreef>(octomap_octree);
+    }
+    else
+    {
+        octomap_octree->swapContent(*octomap_octree_new);   // The old content is freed together with 'octomap_octree_new'
+        octree->computeLocalAABB();
+    }
+
+    num_updates++;
+}
+
+// Occupied voxels are drawn as one CUBE_LIST marker per voxel size. Nothing is built when nobody listens, 
+// and the markers are published again only when the octree has changed, or when a new subscriber has appeared.
+// When streaming, this is called by 'visualization_timer', which limits the rate to 'visualization_rate'.
+// Meanwhile, received updates are postponed (see 'applyPendingUpdate'), instead of waiting for the visualization.
 void sim_bringup::Octomap::visualize()
 {
-    std::vector<std::array<float, 6>> boxes { octree->toBoxes() };
-    visualization_msgs::msg::MarkerArray marker_array_msg {};
+    std::lock_guard<std::mutex> lock(octree_mutex);
+    if (octree == nullptr || marker_array_publisher == nullptr)
+        return;
+
+    const size_t num_subscribers_new { marker_array_publisher->get_subscription_count() };
+    const bool new_subscriber { num_subscribers_new > num_subscribers };
+    num_subscribers = num_subscribers_new;
+    if (num_subscribers == 0 || (num_updates.load() == num_updates_visualized && !new_subscriber))
+        return;
+
+    std::vector<std::array<float, 6>> boxes { octree->toBoxes() };     // Each box is (x, y, z, size, cost, threshold)
+    std::map<float, visualization_msgs::msg::Marker> markers {};        // Voxel size -> marker
+    geometry_msgs::msg::Point point {};
 
-    for (size_t i = 0; i < boxes.size(); i++) 
+    for (const std::array<float, 6> &box : boxes)
     {
-        RCLCPP_INFO(rclcpp::get_logger("rclcpp"), "Box %ld: (%f, %f, %f)", i, boxes[i][0], boxes[i][1], boxes[i][2]);
-        visualization_msgs::msg::Marker marker {};
-        marker.type = visualization_msgs::msg::Marker::CUBE;
-        marker.action = visualization_msgs::msg::Marker::ADD;
-        marker.ns = "octree_boxes";
-        marker.id = i;
-        marker.header.frame_id = "world";
-        // marker.header.stamp = now();
-        marker.pose.position.x = boxes[i][0];
-        marker.pose.position.y = boxes[i][1];
-        marker.pose.position.z = boxes[i][2];
-        marker.pose.orientation.x = 0.0;
-        marker.pose.orientation.y = 0.0;
-        marker.pose.orientation.z = 0.0;
-        marker.pose.orientation.w = 1.0;
-        marker.scale.x = 0.05;
-        marker.scale.y = 0.05;
-        marker.scale.z = 0.05;
-        marker.color.r = 0.0;
-        marker.color.g = 0.0;
-        marker.color.b = 1.0;
-        marker.color.a = 1.0;
-        marker_array_msg.markers.emplace_back(marker);
+        auto it { markers.find(box[3]) };
+        if (it == markers.end())
+        {
+            visualization_msgs::msg::Marker marker {};
+            marker.type = visualization_msgs::msg::Marker::CUBE_LIST;
+            marker.action = visualization_msgs::msg::Marker::ADD;
+            marker.ns = "octree_boxes";
+            marker.id = markers.size();
+            marker.header.frame_id = "world";
+            // marker.header.stamp = now();
+            marker.pose.orientation.w = 1.0;
+            marker.scale.x = box[3];
+            marker.scale.y = box[3];
+            marker.scale.z = box[3];
+            marker.color.r = 0.0;
+            marker.color.g = 0.0;
+            marker.color.b = 1.0;
+            marker.color.a = 1.0;
+            it = markers.emplace(box[3], marker).first;
+        }
+        point.x = box[0];
+        point.y = box[1];
+        point.z = box[2];
+        it->second.points.emplace_back(point);
     }
+
+    visualization_msgs::msg::MarkerArray marker_array_msg {};
+    marker_array_msg.markers.reserve(markers.size() + 1);
+    visualization_msgs::msg::Marker delete_marker {};
+    delete_marker.action = visualization_msgs::msg::Marker::DELETEALL;  // Voxel sizes may differ from the previous visualization
+    delete_marker.ns = "octree_boxes";
+    marker_array_msg.markers.emplace_back(delete_marker);
+    for (auto &marker : markers)
+        marker_array_msg.markers.emplace_back(std::move(marker.second));
+
     marker_array_publisher->publish(marker_array_msg);
-    RCLCPP_INFO(rclcpp::get_logger("rclcpp"), "Visualizing octree boxes...");
+    num_updates_visualized = num_updates.load();
+    RCLCPP_DEBUG(rclcpp::get_logger("rclcpp"), "Visualizing %ld octree boxes...", boxes.size());
 }
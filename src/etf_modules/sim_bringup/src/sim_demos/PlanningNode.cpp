@@ -3,20 +3,17 @@
 sim_bringup::PlanningNode::PlanningNode(const std::string &node_name, const std::string &config_file_path) : 
     BaseNode(node_name, config_file_path),
     AABB(config_file_path),
-    Octomap(config_file_path),
     ConvexHulls(config_file_path)
 {
     AABB::setEnvironment(Planner::scenario->getEnvironment());
+    AABB::clock = this->get_clock();
     if (AABB::getMinNumCaptures() == 1)
         AABB::subscription = this->create_subscription<sensor_msgs::msg::PointCloud2>
-            ("/bounding_boxes", 10, std::bind(&AABB::callback, this, std::placeholders::_1));
+            ("/bounding_boxes", 10, BaseNode::synchronized(this, &AABB::callback));
     else
         AABB::subscription = this->create_subscription<sensor_msgs::msg::PointCloud2>
-            ("/bounding_boxes", 10, std::bind(&AABB::withFilteringCallback, this, std::placeholders::_1));
+            ("/bounding_boxes", 10, BaseNode::synchronized(this, &AABB::withFilteringCallback));
 
-    // Octomap::marker_array_publisher = this->create_publisher<visualization_msgs::msg::MarkerArray>
-    //     ("/occupied_cells_vis_array", 10);
-    
     // ConvexHulls::points_subscription = this->create_subscription<sensor_msgs::msg::PointCloud2>
     //     ("/convex_hulls", 10, std::bind(&ConvexHulls::pointsCallback, this, std::placeholders::_1));
     // ConvexHulls::polygons_subscription = this->create_subscription<sensor_msgs::msg::PointCloud2>
@@ -48,11 +45,11 @@ void sim_bringup::PlanningNode::planningCallback()
         {
             RCLCPP_INFO(rclcpp::get_logger("rclcpp"), "Updating the environment..."); 
             AABB::updateEnvironment();
+            updateOctree();
 
             RCLCPP_INFO(rclcpp::get_logger("rclcpp"), "Planning the path..."); 
-            if (Planner::solve())
+            if (Planner::solve() && isPathStillValid())
             {
-                Planner::preprocessPath(Planner::getPath(), path);
                 Trajectory::clear();
                 // Trajectory::addPath(path);
                 Trajectory::addPath(path, false);
@@ -75,3 +72,22 @@ void sim_bringup::PlanningNode::planningCallback()
     }
     RCLCPP_INFO(rclcpp::get_logger("rclcpp"), "----------------------------------------------------------------\n");
 }
+
+// Obstacles may move during planning, so the preprocessed path is checked against their latest positions before execution.
+// When the obstacles are filtered over several captures, they are not updated again, since the measurements are already reset.
+bool sim_bringup::PlanningNode::isPathStillValid()
+{
+    if (AABB::getMinNumCaptures() == 1)
+        AABB::updateEnvironment();
+    updateOctree();
+
+    int idx_invalid { Planner::preprocessAndValidatePath(Planner::getPath(), path) };
+    if (idx_invalid != -1)
+    {
+        RCLCPP_WARN(rclcpp::get_logger("rclcpp"), "The path is not valid anymore (at state %d of %ld)! Replanning...", 
+            idx_invalid, path.size());
+        return false;
+    }
+
+    return true;
+}
@@ -6,34 +6,61 @@ sim_bringup::RealTimePlanningNode::RealTimePlanningNode(const std::string &node_
                                                         const std::string &output_file_name) : 
     BaseNode(node_name, config_file_path),
     AABB(config_file_path),
-    DP(Planner::scenario->getStateSpace(), Planner::scenario->getStart(), Planner::scenario->getGoal())
+    DP(Planner::scenario->getStateSpace(), Planner::scenario->getStart(), Planner::scenario->getGoal()),
+    replanning_worker([this]() { Planner::cancel(); })
 {
     YAML::Node node { YAML::LoadFile(project_abs_path + config_file_path) };
 
     AABB::setEnvironment(Planner::scenario->getEnvironment());
+    AABB::clock = this->get_clock();
     if (AABB::getMinNumCaptures() == 1)
         AABB::subscription = this->create_subscription<sensor_msgs::msg::PointCloud2>
-            ("/bounding_boxes", 10, std::bind(&AABB::callback, this, std::placeholders::_1));
+            ("/bounding_boxes", 10, BaseNode::synchronized(this, &AABB::callback));
     else
         AABB::subscription = this->create_subscription<sensor_msgs::msg::PointCloud2>
-            ("/bounding_boxes", 10, std::bind(&AABB::withFilteringCallback, this, std::placeholders::_1));
+            ("/bounding_boxes", 10, BaseNode::synchronized(this, &AABB::withFilteringCallback));
 
     YAML::Node real_time_node { node["real_time"] };
-    std::string real_time_scheduling { real_time_node["scheduling"].as<std::string>() };
-    if (real_time_scheduling == "FPS")
-        DRGBTConfig::REAL_TIME_SCHEDULING = planning::RealTimeScheduling::FPS;
-    else if (real_time_scheduling == "None")
-        DRGBTConfig::REAL_TIME_SCHEDULING = planning::RealTimeScheduling::None;
-
-    DRGBTConfig::MAX_PLANNING_TIME = INFINITY;
-    DRGBTConfig::MAX_TIME_TASK1 = real_time_node["max_time_task1"].as<float>();
-    DRGBTConfig::MAX_ITER_TIME = BaseNode::period;
-    DRGBTConfig::STATIC_PLANNER_TYPE = Planner::getPlannerType();
-    if (DRGBTConfig::STATIC_PLANNER_TYPE == planning::PlannerType::RGBMTStar)
-        RGBMTStarConfig::TERMINATE_WHEN_PATH_IS_FOUND = true;
+    {
+        // DRGBT settings are static, so they are written under the same lock as all other static planner settings
+        std::lock_guard<std::mutex> lock(StaticPlannerConfig::getMutex());
+        std::string real_time_scheduling { real_time_node["scheduling"].as<std::string>() };
+        if (real_time_scheduling == "FPS")
+            DRGBTConfig::REAL_TIME_SCHEDULING = planning::RealTimeScheduling::FPS;
+        else if (real_time_scheduling == "None")
+            DRGBTConfig::REAL_TIME_SCHEDULING = planning::RealTimeScheduling::None;
+
+        DRGBTConfig::MAX_PLANNING_TIME = INFINITY;
+        DRGBTConfig::MAX_TIME_TASK1 = real_time_node["max_time_task1"].as<float>();
+        DRGBTConfig::MAX_ITER_TIME = BaseNode::period;
+        DRGBTConfig::STATIC_PLANNER_TYPE = Planner::getPlannerType();
+    }
+
+    // Obstacles are swept over one iteration, so the horizon is evaluated against their positions until the next iteration
+    YAML::Node obstacle_prediction_node { real_time_node["obstacle_prediction"] };
+    if (obstacle_prediction_node.IsDefined() && obstacle_prediction_node.as<bool>())
+        AABB::setPredictionHorizon(BaseNode::period);
+
+    // Robot state and obstacles are taken at the iteration start (using timestamps of their messages), instead of their reception
+    YAML::Node latency_compensation_node { real_time_node["latency_compensation"] };
+    AABB::setLatencyCompensation(latency_compensation_node.IsDefined() && latency_compensation_node.as<bool>());
+
+    // Replanning must fit into an iteration, so RGBMT* returns the first found path (only for this node's planner)
+    PlannerConfig planner_config { Planner::getConfig() };
+    planner_config.terminate_when_path_is_found = true;
+    Planner::setConfig(planner_config);
     
     replanning_result = -1;
 
+    if (DRGBTConfig::REAL_TIME_SCHEDULING == planning::RealTimeScheduling::FPS)
+    {
+        // Replanning runs in a persistent thread, optionally pinned to a CPU and prioritised (SCHED_FIFO)
+        YAML::Node replanning_cpu_node { real_time_node["replanning_cpu"] };
+        YAML::Node replanning_priority_node { real_time_node["replanning_priority"] };
+        replanning_worker.start(replanning_cpu_node.IsDefined() ? replanning_cpu_node.as<int>() : -1, 
+                                replanning_priority_node.IsDefined() ? replanning_priority_node.as<int>() : 0);
+    }
+
     if (!output_file_name.empty())
     {
         std::cout << "Recorded data will be saved to: " 
@@ -44,22 +71,33 @@ sim_bringup::RealTimePlanningNode::RealTimePlanningNode(const std::string &node_
     }
 }
 
+sim_bringup::RealTimePlanningNode::~RealTimePlanningNode()
+{
+    BaseNode::stopRealTimeLoop();
+
+    if (Robot::getJointsStateLatency().getNumSamples() > 0)
+        RCLCPP_INFO(rclcpp::get_logger("rclcpp"), "Joint states latency: %s", Robot::getJointsStateLatency().toString("[ms]").c_str());
+    if (AABB::getObstaclesLatency().getNumSamples() > 0)
+        RCLCPP_INFO(rclcpp::get_logger("rclcpp"), "Obstacles latency: %s", AABB::getObstaclesLatency().toString("[ms]").c_str());
+}
+
 void sim_bringup::RealTimePlanningNode::planningCallback()
 {
-    RCLCPP_INFO(rclcpp::get_logger("rclcpp"), "----------------------------------------------------------------------------");
-    RCLCPP_DEBUG(rclcpp::get_logger("rclcpp"), "Iteration num. %ld", DP::planner_info->getNumIterations());
+    FAST_LOG_INFO("----------------------------------------------------------------------------");
+    FAST_LOG_DEBUG("Iteration num. %ld", DP::planner_info->getNumIterations());
     DP::time_iter_start = std::chrono::steady_clock::now();     // Start the iteration clock
     AABB::updateEnvironment();
+    BaseNode::updateOctree();
 
-    if (replanning_result == 1)  // New path is found within the specified time limit, thus update predefined path to the goal
+    if (replanning_result.load(std::memory_order_acquire) == 1)  // New path is found within the specified time limit, thus update predefined path to the goal
     {
-        RCLCPP_INFO(rclcpp::get_logger("rclcpp"), "The path has been replanned in %f [ms].", Planner::getPlanningTime() * 1e3);
+        FAST_LOG_INFO("The path has been replanned in %f [ms].", Planner::getPlanningTime() * 1e3);
         Planner::preprocessPath(Planner::getPath(), DP::predefined_path, DP::max_edge_length);
         DP::clearHorizon(base::State::Status::Reached, false);
         DP::q_next = std::make_shared<planning::drbt::HorizonState>(DP::q_target, 0);
-        replanning_result = -1;
+        replanning_result.store(-1, std::memory_order_release);
     }
-    else if (replanning_result == 0)
+    else if (replanning_result.load(std::memory_order_acquire) == 0)
     {
         RCLCPP_WARN(rclcpp::get_logger("rclcpp"), "Replanning is required. New path is not found! ");
         DP::replanning = true;
@@ -96,10 +134,26 @@ void sim_bringup::RealTimePlanningNode::planningCallback()
         // std::cout << "q_current (computed): " << DP::q_current << "\n";
         // std::cout << "q_current_dot (measured): " << Robot::getJointsVelocityPtr() << "\n";
         // std::cout << "q_current_dot (computed): " << DP::ss->getNewState(DP::spline_next->getVelocity(DP::spline_next->getTimeCurrent(true))) << "\n";
+
+        // Measured robot state, interpolated from the stamped joint states up to the iteration start. 
+        // It is never extrapolated past the latest joint state, since the emergency stop must not be triggered by a prediction.
+        q_measured = nullptr;
+        if (AABB::isLatencyCompensation())
+        {
+            const rclcpp::Time time_iter { Robot::clock->now() };
+            const float age { Robot::getJointsStateAge(time_iter) };
+            const rclcpp::Time time_measured { age > 0 ? time_iter - rclcpp::Duration::from_seconds(age) : time_iter };
+            if (Robot::getJointsState(time_measured, q_measured_vec, q_measured_dot_vec))
+            {
+                q_measured = DP::ss->getNewState(q_measured_vec);
+                FAST_LOG_DEBUG("Age of joint state: %f [ms]. Tracking error: %f [rad].", 
+                    age * 1e3, (q_measured_vec - DP::q_current->getCoord()).norm());
+            }
+        }
         
         // ------------------------------------------------------------------------------- //
-        // Checking whether the collision occurs
-        if (!DP::ss->isValid(DP::q_current))
+        // Checking whether the collision occurs (either for the computed or the measured robot state)
+        if (!DP::ss->isValid(DP::q_current) || (q_measured != nullptr && !DP::ss->isValid(q_measured)))
         {
             RCLCPP_ERROR(rclcpp::get_logger("rclcpp"), "********** Robot is stopping. Collision has been occurred!!! **********");
             DP::q_target = DP::q_current;
@@ -125,7 +179,7 @@ void sim_bringup::RealTimePlanningNode::planningCallback()
     // ------------------------------------------------------------------------------- //
     // Checking the real-time execution
     float time_iter_remain = DRGBTConfig::MAX_ITER_TIME * 1e3 - DP::getElapsedTime(DP::time_iter_start, planning::TimeUnit::ms);
-    RCLCPP_INFO(rclcpp::get_logger("rclcpp"), "Remaining iteration time is %f [ms].", time_iter_remain);
+    FAST_LOG_INFO("Remaining iteration time is %f [ms].", time_iter_remain);
     if (time_iter_remain < 0)
         RCLCPP_ERROR(rclcpp::get_logger("rclcpp"), "********** Real-time is broken. %f [ms] exceeded!!! **********", -time_iter_remain);
 
@@ -140,7 +194,7 @@ void sim_bringup::RealTimePlanningNode::planningCallback()
 
 void sim_bringup::RealTimePlanningNode::taskComputingNextConfiguration()
 {
-    RCLCPP_INFO(rclcpp::get_logger("rclcpp"), "TASK 1: Computing next configuration... ");
+    FAST_LOG_INFO("TASK 1: Computing next configuration... ");
     
     // Since the environment may change, a new distance is required!
     float d_c { DP::ss->computeDistance(DP::q_target, true) };
@@ -162,27 +216,27 @@ void sim_bringup::RealTimePlanningNode::taskComputingNextConfiguration()
     DP::generateGBur();
     DP::computeNextState();
     computeTrajectory();
-    RCLCPP_INFO(rclcpp::get_logger("rclcpp"), "Elapsed time for TASK 1: %f [ms].", DP::getElapsedTime(DP::time_iter_start, planning::TimeUnit::ms));
+    FAST_LOG_INFO("Elapsed time for TASK 1: %f [ms].", DP::getElapsedTime(DP::time_iter_start, planning::TimeUnit::ms));
 }
 
 void sim_bringup::RealTimePlanningNode::taskReplanning()
 {
     if (DP::whetherToReplan())
     {
-        RCLCPP_INFO(rclcpp::get_logger("rclcpp"), "TASK 2: Replanning... ");
+        FAST_LOG_INFO("TASK 2: Replanning... ");
         if (Planner::isReady())
             replan(DRGBTConfig::MAX_ITER_TIME - DP::getElapsedTime(DP::time_iter_start) - 2e-3);    // 2 [ms] is reserved for other lines
         else
             RCLCPP_WARN(rclcpp::get_logger("rclcpp"), "Planner is not ready! ");
     }
     else
-        RCLCPP_INFO(rclcpp::get_logger("rclcpp"), "Replanning is not required! ");
+        FAST_LOG_INFO("Replanning is not required! ");
 }
 
 // Try to replan the predefined path from the target to the goal configuration within the specified time
 void sim_bringup::RealTimePlanningNode::replan(float max_planning_time)
 {
-    replanning_result = false;
+    replanning_result.store(0, std::memory_order_release);
     try
     {
         if (max_planning_time < 0)
@@ -192,18 +246,25 @@ void sim_bringup::RealTimePlanningNode::replan(float max_planning_time)
         {
         case planning::RealTimeScheduling::FPS:
         {
-            RCLCPP_INFO(rclcpp::get_logger("rclcpp"), "Replanning with Fixed Priority Scheduling ");
-            RCLCPP_INFO(rclcpp::get_logger("rclcpp"), "Trying to replan in %f [ms]...", max_planning_time * 1e3);
-            std::thread replanning_thread([this, &max_planning_time]() 
+            FAST_LOG_INFO("Replanning with Fixed Priority Scheduling ");
+            FAST_LOG_INFO("Trying to replan in %f [ms]...", max_planning_time * 1e3);
+            // Everything is captured by value, since the job outlives this call. 
+            // A result of a cancelled job is stale, thus it is not published to the control loop.
+            replanning_worker.submit([this, q_start = DP::q_target, q_goal = DP::q_goal, max_planning_time]
+                (const CancellationToken &token)
             {
-                replanning_result = Planner::solve(DP::q_target, DP::q_goal, max_planning_time);
+                if (token.isCancelled())
+                    return;
+                
+                bool result { Planner::solve(q_start, q_goal, max_planning_time) };
+                if (!token.isCancelled())
+                    replanning_result.store(result, std::memory_order_release);
             });
-            replanning_thread.detach();
             break;
         }
         case planning::RealTimeScheduling::None:
-            RCLCPP_INFO(rclcpp::get_logger("rclcpp"), "Replanning without real-time scheduling ");
-            RCLCPP_INFO(rclcpp::get_logger("rclcpp"), "Trying to replan in %f [ms]...", max_planning_time * 1e3);
+            FAST_LOG_INFO("Replanning without real-time scheduling ");
+            FAST_LOG_INFO("Trying to replan in %f [ms]...", max_planning_time * 1e3);
             replanning_result = Planner::solve(DP::q_target, DP::q_goal, max_planning_time);
             break;
         }
@@ -221,41 +282,65 @@ void sim_bringup::RealTimePlanningNode::computeTrajectory()
     float t_delay { DP::updateCurrentState(true) };
     if (DP::spline_next == DP::spline_current)  // Trajectory has been already computed!
     {
-        RCLCPP_INFO(rclcpp::get_logger("rclcpp"), "Not computing a new trajectory! ");
+        FAST_LOG_INFO("Not computing a new trajectory! ");
         return;
     }
 
-    RCLCPP_INFO(rclcpp::get_logger("rclcpp"), "New trajectory is computed! Delay time: %f [ms]", t_delay * 1e3);
+    FAST_LOG_INFO("New trajectory is computed! Delay time: %f [ms]", t_delay * 1e3);
     DP::spline_next->setTimeStart(t_delay);
 
     std::chrono::steady_clock::time_point time_start_ { std::chrono::steady_clock::now() };
     Trajectory::clear();
     Trajectory::addPoints(DP::spline_next, 0.0f, DP::spline_next->getTimeFinal());
-    RCLCPP_INFO(rclcpp::get_logger("rclcpp"), "Elapsed time: %f [ms] for adding %ld points", 
-                DP::getElapsedTime(time_start_) * 1e3, Trajectory::getNumPoints());
+    FAST_LOG_INFO("Elapsed time: %f [ms] for adding %ld points", 
+                  DP::getElapsedTime(time_start_) * 1e3, Trajectory::getNumPoints());
+
+    // The trajectory is released when 't_delay' exceeds, while this thread continues with the iteration
+    Trajectory::publishAt(time_start_ + std::chrono::microseconds(int64_t(t_delay * 1e6)));
+}
 
-    while (DP::getElapsedTime(time_start_) < t_delay) {}    // Wait for 't_delay' to exceed...
-    Trajectory::publish();
+// Copy the data needed by the timer callbacks, so they never read the planner state while it is being modified
+void sim_bringup::RealTimePlanningNode::handOffSnapshot()
+{
+    if (DP::planner_info->getNumIterations() == 0 || DP::spline_next == nullptr)
+        return;
+
+    std::lock_guard<std::mutex> lock(snapshot_mutex);
+    snapshot.spline = DP::spline_next;
+    snapshot.time_spline = DP::spline_next->getTimeCurrent(true);
+    snapshot.time_elapsed = DP::getElapsedTime(DP::time_alg_start);
+    snapshot.time_taken = std::chrono::steady_clock::now();
+    snapshot.num_iterations = DP::planner_info->getNumIterations();
+    snapshot.joints_position = Robot::getJointsPosition();      // Buffers are reused after the first copy
+    snapshot.joints_velocity = Robot::getJointsVelocity();
+}
+
+sim_bringup::RealTimePlanningNode::Snapshot sim_bringup::RealTimePlanningNode::getSnapshot()
+{
+    std::lock_guard<std::mutex> lock(snapshot_mutex);
+    return snapshot;
 }
 
 void sim_bringup::RealTimePlanningNode::recordingTrajectoryCallback()
 {
-    if (DP::getPlannerInfo()->getNumIterations() == 0)
+    const Snapshot snapshot_ { getSnapshot() };
+    if (snapshot_.num_iterations == 0)
         return;
 
-    float time_spline { DP::spline_next->getTimeCurrent(true) };
+    const float time_since { std::chrono::duration<float>(std::chrono::steady_clock::now() - snapshot_.time_taken).count() };
+    const float time_spline { snapshot_.time_spline + time_since };
     output_file << "Time [s]: \n";
-    output_file << DP::getElapsedTime(DP::time_alg_start) << "\n";
+    output_file << snapshot_.time_elapsed + time_since << "\n";
 
     output_file << "Position (referent): \n";
-    output_file << DP::spline_next->getPosition(time_spline).transpose() << "\n";
+    output_file << snapshot_.spline->getPosition(time_spline).transpose() << "\n";
     output_file << "Position (measured): \n";
-    output_file << Robot::getJointsPosition().transpose() << "\n";
+    output_file << snapshot_.joints_position.transpose() << "\n";
 
     output_file << "Velocity (referent): \n";
-    output_file << DP::spline_next->getVelocity(time_spline).transpose() << "\n";
+    output_file << snapshot_.spline->getVelocity(time_spline).transpose() << "\n";
     output_file << "Velocity (measured): \n";
-    output_file << Robot::getJointsVelocity().transpose() << "\n";
+    output_file << snapshot_.joints_velocity.transpose() << "\n";
 
     // output_file << "Acceleration (referent): \n";
     // output_file << DP::spline_next->getAcceleration(time_spline).transpose() << "\n";
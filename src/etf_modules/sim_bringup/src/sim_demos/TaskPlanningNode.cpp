@@ -10,7 +10,30 @@ sim_bringup::TaskPlanningNode::TaskPlanningNode(const std::string &node_name, co
     for (size_t i = 0; i < 3; i++)
         destination(i) = scenario_node["destination"][i].as<float>();
 
-    IK_computed = -1;
+    if (scenario_node["grasp_yaw_offsets"].IsDefined())
+    {
+        for (size_t i = 0; i < scenario_node["grasp_yaw_offsets"].size(); i++)
+            grasp_yaw_offsets.emplace_back(scenario_node["grasp_yaw_offsets"][i].as<float>());
+    }
+    if (grasp_yaw_offsets.empty())
+        grasp_yaw_offsets.emplace_back(0);
+
+    pipelined_planning = scenario_node["pipelined_planning"].IsDefined() ? scenario_node["pipelined_planning"].as<bool>() : false;
+
+    // IK attempts run in parallel, each with its own robot instance
+    YAML::Node IK_node { node["robot"]["IK"] };
+    size_t IK_num_threads { 4 };
+    size_t IK_num_attempts { 11 };
+    if (IK_node.IsDefined())
+    {
+        if (IK_node["num_threads"].IsDefined())
+            IK_num_threads = IK_node["num_threads"].as<size_t>();
+        if (IK_node["num_attempts"].IsDefined())
+            IK_num_attempts = IK_node["num_attempts"].as<size_t>();
+    }
+    inverse_kinematics = std::make_unique<sim_bringup::InverseKinematics>
+        ([this]() { return Robot::createRobot(); }, IK_num_threads, IK_num_attempts);
+
     task = waiting_for_object;
     state = State::planning;
 }
@@ -29,27 +52,20 @@ void sim_bringup::TaskPlanningNode::taskPlanningCallback()
         break;
 
     case choosing_object:
-        obj_idx = chooseObject();
-        if (obj_idx != -1)
-        {
-            task = computing_IK;
-            IK_computed = computeObjectApproachAndPickStates();
-        }
-        else
-            task = waiting_for_object;
+        grasp_candidates = computeGraspCandidates();
+        task = grasp_candidates.empty() ? waiting_for_object : choosing_grasp;
         break;
 
-    case computing_IK:
-        if (IK_computed == 1)
+    case choosing_grasp:
+        if (takeNextGraspCandidate())
         {
             AABB::resetMeasurements();
             Planner::scenario->setStart(Robot::getJointsPositionPtr());
             Planner::scenario->setGoal(q_object_approach1);
             task = planning;
             task_next = going_towards_object;
-            IK_computed = -1;
         }
-        else if (IK_computed == 0)
+        else
             task = waiting_for_object;
         
         break;
@@ -81,12 +97,15 @@ void sim_bringup::TaskPlanningNode::taskPlanningCallback()
 
     case moving_object_to_destination:
         RCLCPP_INFO(rclcpp::get_logger("rclcpp"), "Moving the object to destination...");
+        task = planning;
+        task_next = releasing_object;
+        if (takePlannedNextLeg())
+            break;
+
         AABB::resetMeasurements();
         q_object_approach1 = Planner::scenario->getStateSpace()->getNewState(q_object_approach1->getCoord());   // Reset all additional data set before for 'q_object_approach1'
         Planner::scenario->setStart(q_object_approach1);
         Planner::scenario->setGoal(q_goal);
-        task = planning;
-        task_next = releasing_object;
         break;
     
     case releasing_object:
@@ -110,16 +129,31 @@ void sim_bringup::TaskPlanningNode::planningCase()
         break;
     
     case State::planning:
+        discardPlannedNextLeg();
         if (Planner::isReady() && AABB::isReady())
         {
             AABB::updateEnvironment();
+            updateOctree();
             if (Planner::solve())
             {
-                Planner::preprocessPath(Planner::getPath(), path);
-                Trajectory::clear();
-                Trajectory::addPath(path, false);
-                Trajectory::publish();
-                state = State::executing_trajectory;
+                if (isPathStillValid())
+                {
+                    Trajectory::clear();
+                    Trajectory::addPath(path, false);
+                    Trajectory::publish();
+                    state = State::executing_trajectory;
+                    q_leg_goal = Planner::scenario->getGoal();
+
+                    // Object's destination is already known, so the robot does not need to wait for that leg to be planned
+                    if (task_next == going_towards_object)
+                        startPlanningNextLeg(q_object_approach1, q_goal);
+                }
+            }
+            else if (task_next == going_towards_object && !grasp_candidates.empty())
+            {
+                // There is no need to wait for another perception cycle
+                RCLCPP_INFO(rclcpp::get_logger("rclcpp"), "Trying the next grasp candidate...");
+                task = choosing_grasp;
             }
         }
         else
@@ -128,7 +162,7 @@ void sim_bringup::TaskPlanningNode::planningCase()
 
     case State::executing_trajectory:
         RCLCPP_INFO(rclcpp::get_logger("rclcpp"), "Executing trajectory...");            
-        if (Robot::isReached(Planner::scenario->getGoal()))
+        if (Robot::isReached(q_leg_goal))
         {
             state = State::planning;
             task = task_next;
@@ -137,10 +171,71 @@ void sim_bringup::TaskPlanningNode::planningCase()
     }
 }
 
-bool sim_bringup::TaskPlanningNode::computeObjectApproachAndPickStates()
+/// @brief Generate grasp candidates for all pickable objects, and rank them.
+/// For each object, the gripper approaches from above, either from the inner or the outer side (w.r.t. the robot base),
+/// and it is rotated around its axis by each of 'grasp_yaw_offsets'. IK is solved for each candidate (with parallel attempts),
+/// and then the approach and goal configurations of all candidates are checked for collision in parallel.
+/// @return Valid candidates sorted by the joint-space distance to be travelled.
+std::deque<sim_bringup::GraspCandidate> sim_bringup::TaskPlanningNode::computeGraspCandidates()
+{
+    discardPlannedNextLeg();    // The planner and the environment are used below
+    std::vector<sim_bringup::GraspCandidate> candidates {};
+    size_t num_generated { 0 };
+    for (size_t i = 0; i < positions.size(); i++)
+    {
+        RCLCPP_INFO(rclcpp::get_logger("rclcpp"), "Object %ld. dim = (%f, %f, %f), pos = (%f, %f, %f). Num. captures %ld.",
+            i, dimensions[i].x(), dimensions[i].y(), dimensions[i].z(), 
+               positions[i].x(), positions[i].y(), positions[i].z(), num_captures[i]);
+        if (!isPickable(i))
+            continue;
+
+        for (int side : {-1, 1})
+        {
+            for (float yaw_offset : grasp_yaw_offsets)
+            {
+                num_generated++;
+                sim_bringup::GraspCandidate candidate {};
+                if (computeGraspCandidate(i, side, yaw_offset, candidate))
+                    candidates.emplace_back(candidate);
+            }
+        }
+    }
+
+    AABB::updateEnvironment();
+    updateOctree();
+    std::vector<std::vector<std::shared_ptr<base::State>>> states {};
+    for (const sim_bringup::GraspCandidate &candidate : candidates)
+    {
+        states.push_back({ candidate.q_approach1 });
+        states.push_back({ candidate.q_goal });
+    }
+    const std::vector<int> indices_invalid { Planner::validatePaths(states) };
+
+    std::deque<sim_bringup::GraspCandidate> candidates_valid {};
+    for (size_t k = 0; k < candidates.size(); k++)
+    {
+        if (indices_invalid[2*k] == -1 && indices_invalid[2*k+1] == -1)
+            candidates_valid.emplace_back(candidates[k]);
+    }
+    std::sort(candidates_valid.begin(), candidates_valid.end(), 
+        [](const sim_bringup::GraspCandidate &a, const sim_bringup::GraspCandidate &b) { return a.cost < b.cost; });
+
+    RCLCPP_INFO(rclcpp::get_logger("rclcpp"), "Valid grasp candidates: %ld (IK solved for %ld of %ld).", 
+        candidates_valid.size(), candidates.size(), num_generated);
+    
+    return candidates_valid;
+}
+
+/// @brief Compute all configurations for grasping the object 'obj_idx_' from above.
+/// @param side Whether the gripper approaches from the outer (+1) or the inner (-1) side of the object (w.r.t. the robot base).
+/// @param yaw_offset Rotation of the gripper around its axis in [rad].
+/// @param candidate Computed grasp candidate (output).
+/// @return Whether IK is solved for all configurations.
+bool sim_bringup::TaskPlanningNode::computeGraspCandidate(size_t obj_idx_, int side, float yaw_offset, 
+    sim_bringup::GraspCandidate &candidate)
 {
-    const Eigen::Vector3f pos { AABB::getPositions(obj_idx) };
-    const Eigen::Vector3f dim { AABB::getDimensions(obj_idx) };
+    const Eigen::Vector3f pos { AABB::getPositions(obj_idx_) };
+    const Eigen::Vector3f dim { AABB::getDimensions(obj_idx_) };
 
     // For approaching from above
     KDL::Vector n(pos.x(), pos.y(), 0); n.Normalize();
@@ -152,19 +247,15 @@ bool sim_bringup::TaskPlanningNode::computeObjectApproachAndPickStates()
     // KDL::Vector s(-pos.y(), pos.x(), 0); s.Normalize();
     // KDL::Vector a(pos.x(), pos.y(), 0); a.Normalize();
 
-    KDL::Rotation R(n, s, a);
+    KDL::Rotation R { KDL::Rotation(n, s, a) * KDL::Rotation::RotZ(yaw_offset) };
     // RCLCPP_INFO(rclcpp::get_logger("rclcpp"), "Rotation matrix: ");
     // RCLCPP_INFO(rclcpp::get_logger("rclcpp"), "Vector n: (%f, %f, %f)", R(0,0), R(1,0), R(2,0));
     // RCLCPP_INFO(rclcpp::get_logger("rclcpp"), "Vector s: (%f, %f, %f)", R(0,1), R(1,1), R(2,1));
     // RCLCPP_INFO(rclcpp::get_logger("rclcpp"), "Vector a: (%f, %f, %f)", R(0,2), R(1,2), R(2,2));
     
     float fi { std::atan2(pos.y(), pos.x()) };
-    float r { pos.head(2).norm() };
+    float r { pos.head(2).norm() + side * 1.5f * dim.head(2).norm() };
     float r_crit { 0.3 };
-    if (r < r_crit)
-        r += 1.5 * dim.head(2).norm();
-    else
-        r -= 1.5 * dim.head(2).norm();
 
     float p_pick_z { pos.z() };
     if (dim.z() > 0.14)
@@ -179,80 +270,147 @@ bool sim_bringup::TaskPlanningNode::computeObjectApproachAndPickStates()
     KDL::Vector p_pick(pos.x(), 
                        pos.y(), 
                        p_pick_z);
-    size_t num { 0 };
-    std::shared_ptr<base::State> q_init { Robot::getJointsPositionPtr() };
-    while (num++ <= 10)
+    // It is convenient for the purpose when picking objects from above
+    auto wrist_criterion = [r, r_crit](const std::shared_ptr<base::State> &q) -> bool
     {
-        q_object_approach1 = Robot::getRobot()->computeInverseKinematics(R, p_approach1, q_init);
-        if (q_object_approach1 == nullptr)
-        {
-            q_init = nullptr;
-            continue;
-        }
-        
-        // It is convenient for the purpose when picking objects from above
-        if ((r > r_crit && std::abs(q_object_approach1->getCoord(3)) < 0.1) ||
-            (r <= r_crit && std::abs(q_object_approach1->getCoord(3) - (-M_PI)) < 0.1))
-            break;
-    }
-    if (q_object_approach1 == nullptr)
+        return (r > r_crit && std::abs(q->getCoord(3)) < 0.1) || 
+               (r <= r_crit && std::abs(q->getCoord(3) - (-M_PI)) < 0.1);
+    };
+    const std::shared_ptr<base::State> q_current { Robot::getJointsPositionPtr() };
+    candidate.q_approach1 = inverse_kinematics->solve(R, p_approach1, q_current, wrist_criterion);
+    if (candidate.q_approach1 == nullptr)
+        candidate.q_approach1 = inverse_kinematics->solve(R, p_approach1, q_current);
+    if (candidate.q_approach1 == nullptr)
         return false;
 
-    // Just to ensure that 'q_object_approach2' is relatively close to 'q_object_approach1'
-    q_object_approach2 = Robot::getRobot()->computeInverseKinematics(R, p_approach2, q_object_approach1);
-    if (q_object_approach2 == nullptr || std::abs(q_object_approach1->getCoord(3) - q_object_approach2->getCoord(3)) > 0.1)
+    // Just to ensure that 'q_approach2' is relatively close to 'q_approach1'
+    candidate.q_approach2 = inverse_kinematics->solve(R, p_approach2, candidate.q_approach1, 
+        [q_ref = candidate.q_approach1->getCoord()](const std::shared_ptr<base::State> &q) { return std::abs(q_ref(3) - q->getCoord(3)) <= 0.1; });
+    if (candidate.q_approach2 == nullptr)
         return false;
 
-    // Just to ensure that 'q_object_pick' is relatively close to 'q_object_approach2'
-    q_object_pick = Robot::getRobot()->computeInverseKinematics(R, p_pick, q_object_approach2); 
-    if (q_object_pick == nullptr || std::abs(q_object_approach2->getCoord(3) - q_object_pick->getCoord(3)) > 0.1)
+    // Just to ensure that 'q_pick' is relatively close to 'q_approach2'
+    candidate.q_pick = inverse_kinematics->solve(R, p_pick, candidate.q_approach2, 
+        [q_ref = candidate.q_approach2->getCoord()](const std::shared_ptr<base::State> &q) { return std::abs(q_ref(3) - q->getCoord(3)) <= 0.1; });
+    if (candidate.q_pick == nullptr)
         return false;
 
     KDL::Vector p_goal(destination.x(), destination.y(), destination.z() + dim.z());
     KDL::Vector n_goal(destination.x(), destination.y(), 0); n_goal.Normalize();
     KDL::Vector s_goal(destination.y(), -destination.x(), 0); s_goal.Normalize();
     KDL::Vector a_goal(0, 0, -1);
-    KDL::Rotation R_goal(n_goal, s_goal, a_goal);
-    Eigen::VectorXf goal_angles { q_object_pick->getCoord() };
+    KDL::Rotation R_goal { KDL::Rotation(n_goal, s_goal, a_goal) * KDL::Rotation::RotZ(yaw_offset) };
+    Eigen::VectorXf goal_angles { candidate.q_pick->getCoord() };
     goal_angles(0) = std::atan2(destination.y(), destination.x());
-    q_goal = Robot::getRobot()->computeInverseKinematics(R_goal, p_goal, std::make_shared<base::RealVectorSpaceState>(goal_angles));
-    if (q_goal == nullptr)
+    candidate.q_goal = inverse_kinematics->solve(R_goal, p_goal, std::make_shared<base::RealVectorSpaceState>(goal_angles));
+    if (candidate.q_goal == nullptr)
         return false;
     
     // Just to take a shorter angle
-    if (std::abs(std::atan2(pos.y(), pos.x()) - q_goal->getCoord(0)) > M_PI)
+    if (std::abs(std::atan2(pos.y(), pos.x()) - candidate.q_goal->getCoord(0)) > M_PI)
     {
-        if (q_goal->getCoord(0) > 0)
-            q_goal->setCoord(q_goal->getCoord(0) - 2*M_PI, 0);
+        if (candidate.q_goal->getCoord(0) > 0)
+            candidate.q_goal->setCoord(candidate.q_goal->getCoord(0) - 2*M_PI, 0);
         else
-            q_goal->setCoord(q_goal->getCoord(0) + 2*M_PI, 0);
+            candidate.q_goal->setCoord(candidate.q_goal->getCoord(0) + 2*M_PI, 0);
     }
 
+    candidate.obj_idx = obj_idx_;
+    candidate.obj_pos = pos;
+    candidate.cost = (candidate.q_approach1->getCoord() - q_current->getCoord()).norm() + 
+                     (candidate.q_goal->getCoord() - candidate.q_approach1->getCoord()).norm();
     return true;
 }
 
-int sim_bringup::TaskPlanningNode::chooseObject()
+/// @brief Take the best remaining grasp candidate, and set its configurations to be used by the task.
+/// @return Whether there is any remaining candidate.
+bool sim_bringup::TaskPlanningNode::takeNextGraspCandidate()
 {
-    float z_max { -INFINITY };
-    int obj_idx_ { -1 };
-    for (size_t i = 0; i < positions.size(); i++)
+    if (grasp_candidates.empty())
+        return false;
+
+    const sim_bringup::GraspCandidate candidate { grasp_candidates.front() };
+    obj_idx = candidate.obj_idx;
+    q_object_approach1 = candidate.q_approach1;
+    q_object_approach2 = candidate.q_approach2;
+    q_object_pick = candidate.q_pick;
+    q_goal = candidate.q_goal;
+    grasp_candidates.pop_front();
+
+    RCLCPP_INFO(rclcpp::get_logger("rclcpp"), "Object %d is chosen at the position (%f, %f, %f). Remaining grasp candidates: %ld.", 
+        obj_idx, candidate.obj_pos.x(), candidate.obj_pos.y(), candidate.obj_pos.z(), grasp_candidates.size());
+    
+    return true;
+}
+
+// Pick only "small" objects from the table
+bool sim_bringup::TaskPlanningNode::isPickable(size_t idx) const
+{
+    return num_captures[idx] >= min_num_captures && dimensions[idx].z() < max_object_height && 
+           positions[idx].z() < max_object_height / 2;
+}
+
+/// @brief Start planning the leg from 'q_start' to 'q_goal_' in the background, while the current leg is executed.
+/// Until the result is taken (or discarded), nothing else may be planned or validated, and the environment must not be updated.
+/// Streamed octomap updates are held meanwhile, since they modify the octree in place.
+void sim_bringup::TaskPlanningNode::startPlanningNextLeg(const std::shared_ptr<base::State> &q_start, 
+    const std::shared_ptr<base::State> &q_goal_)
+{
+    if (!pipelined_planning || next_leg.valid())
+        return;
+
+    RCLCPP_INFO(rclcpp::get_logger("rclcpp"), "Planning the next leg in the background...");
+    q_next_leg_start = Planner::scenario->getStateSpace()->getNewState(q_start->getCoord());   // Without any additional data set before
+    q_next_leg_goal = q_goal_;
+    if (octomap != nullptr)
+        octomap->holdUpdates();
+    
+    next_leg = std::async(std::launch::async, [this]() { return Planner::solve(q_next_leg_start, q_next_leg_goal); });
+}
+
+/// @brief Take the path of the next leg planned in the background, and execute it if it is still valid in the current environment.
+/// @return Whether its trajectory is published. Otherwise, the leg should be planned as usual.
+bool sim_bringup::TaskPlanningNode::takePlannedNextLeg()
+{
+    if (!next_leg.valid())
+        return false;
+
+    // It is usually finished by now, since the robot was busy with the current leg
+    const bool result { next_leg.get() };
+    if (octomap != nullptr)
+        octomap->resumeUpdates();
+    
+    if (!result)
     {
-        RCLCPP_INFO(rclcpp::get_logger("rclcpp"), "Object %ld. dim = (%f, %f, %f), pos = (%f, %f, %f). Num. captures %ld.",
-            i, dimensions[i].x(), dimensions[i].y(), dimensions[i].z(), 
-               positions[i].x(), positions[i].y(), positions[i].z(), num_captures[i]);
-        if (num_captures[i] >= min_num_captures && positions[i].z() > z_max && 
-            dimensions[i].z() < max_object_height && positions[i].z() < max_object_height / 2)  // Pick only "small" objects from the table
-        {
-            z_max = positions[i].z();
-            obj_idx_ = i;
-        }
+        RCLCPP_WARN(rclcpp::get_logger("rclcpp"), "The next leg is not planned in the background!");
+        return false;
     }
 
-    if (obj_idx_ != -1)
-        RCLCPP_INFO(rclcpp::get_logger("rclcpp"), "Object %d is recognized at the position (%f, %f, %f).", 
-            obj_idx_, positions[obj_idx_].x(), positions[obj_idx_].y(), positions[obj_idx_].z());
-    
-    return obj_idx_;
+    // Obstacles may have moved, so the path is replanned only if it is not valid anymore
+    AABB::updateEnvironment();
+    updateOctree();
+    if (!isPathStillValid())
+        return false;
+
+    RCLCPP_INFO(rclcpp::get_logger("rclcpp"), "Executing the next leg planned in the background...");
+    q_object_approach1 = q_next_leg_start;
+    q_leg_goal = q_next_leg_goal;
+    Trajectory::clear();
+    Trajectory::addPath(path, false);
+    Trajectory::publish();
+    state = State::executing_trajectory;
+    return true;
+}
+
+void sim_bringup::TaskPlanningNode::discardPlannedNextLeg()
+{
+    if (!next_leg.valid())
+        return;
+
+    Planner::cancel();
+    next_leg.get();
+    if (octomap != nullptr)
+        octomap->resumeUpdates();
 }
 
 bool sim_bringup::TaskPlanningNode::whetherToRemove(const Eigen::Vector3f &object_pos, [[maybe_unused]] const Eigen::Vector3f &object_dim)
@@ -0,0 +1,177 @@
+#include "state_spaces/RealVectorSpaceOctree.h"
+
+sim_bringup::RealVectorSpaceOctree::RealVectorSpaceOctree(size_t num_dimensions_, const std::shared_ptr<robots::AbstractRobot> robot_, 
+                                                          const std::shared_ptr<env::Environment> env_) : 
+    RealVectorSpace(num_dimensions_, robot_, env_)
+{
+    robot_octree = robot_;
+    octree = nullptr;
+}
+
+bool sim_bringup::RealVectorSpaceOctree::isValid(const std::shared_ptr<base::State> q)
+{
+    if (!RealVectorSpace::isValid(q))
+        return false;
+
+    return !isInOctreeCollision(q);
+}
+
+float sim_bringup::RealVectorSpaceOctree::computeDistance(const std::shared_ptr<base::State> q, bool compute_again)
+{
+    if (!compute_again && q->getDistance() > 0)
+        return q->getDistance();
+
+    float d_c { RealVectorSpace::computeDistance(q, compute_again) };
+    if (octree == nullptr || d_c <= 0)
+        return d_c;
+
+    d_c = std::min(d_c, computeOctreeDistance(q, d_c));
+    q->setDistance(d_c);
+    return d_c;
+}
+
+/// @brief Compute the minimal distance from the robot's capsules in a configuration 'q' to occupied voxels of 'octree'.
+/// The octree hierarchy is used for pruning, i.e., a subtree is skipped when it is free, 
+/// or when its bounding volume is farther than the minimal distance found so far.
+/// @param q Configuration of the robot.
+/// @param d_max Distance above which the exact value is not needed (the search stops at 'd_max').
+/// @return Minimal distance (at most 'd_max'). Non-positive value means that the collision occurs.
+float sim_bringup::RealVectorSpaceOctree::computeOctreeDistance(const std::shared_ptr<base::State> q, float d_max)
+{
+    if (octree == nullptr || octree->getRoot() == nullptr)
+        return d_max;
+
+    std::shared_ptr<Eigen::MatrixXf> skeleton { robot_octree->computeSkeleton(q) };
+    const fcl::AABBf root_bv { octree->getRootBV() };
+    float d_c { d_max };
+
+    for (size_t k = 0; k < robot_octree->getNumLinks(); k++)
+    {
+        computeOctreeDistance(octree->getRoot(), root_bv, skeleton->col(k), skeleton->col(k+1), robot_octree->getCapsuleRadius(k), d_c);
+        if (d_c <= 0)
+            break;
+    }
+
+    return d_c;
+}
+
+/// @brief Check whether any of the robot's capsules in a configuration 'q' touches an occupied voxel of 'octree'.
+/// Unlike 'computeOctreeDistance', the search stops at the first occupied leaf within a capsule radius.
+bool sim_bringup::RealVectorSpaceOctree::isInOctreeCollision(const std::shared_ptr<base::State> q)
+{
+    if (octree == nullptr || octree->getRoot() == nullptr)
+        return false;
+
+    std::shared_ptr<Eigen::MatrixXf> skeleton { robot_octree->computeSkeleton(q) };
+    const fcl::AABBf root_bv { octree->getRootBV() };
+    for (size_t k = 0; k < robot_octree->getNumLinks(); k++)
+    {
+        if (isInOctreeCollision(octree->getRoot(), root_bv, skeleton->col(k), skeleton->col(k+1), robot_octree->getCapsuleRadius(k)))
+            return true;
+    }
+
+    return false;
+}
+
+bool sim_bringup::RealVectorSpaceOctree::isInOctreeCollision(const fcl::OcTreef::OcTreeNode* node, const fcl::AABBf &bv, 
+    const Eigen::Vector3f &A, const Eigen::Vector3f &B, float radius)
+{
+    if (!octree->isNodeOccupied(node) || distanceLineSegToAABB(A, B, bv) > radius)
+        return false;
+
+    if (!octree->nodeHasChildren(node))
+        return true;
+
+    fcl::AABBf child_bv {};
+    for (unsigned int i = 0; i < 8; i++)
+    {
+        if (!octree->nodeChildExists(node, i))
+            continue;
+
+        fcl::computeChildBV(bv, i, child_bv);
+        if (isInOctreeCollision(octree->getNodeChild(node, i), child_bv, A, B, radius))
+            return true;
+    }
+
+    return false;
+}
+
+void sim_bringup::RealVectorSpaceOctree::computeOctreeDistance(const fcl::OcTreef::OcTreeNode* node, const fcl::AABBf &bv, 
+    const Eigen::Vector3f &A, const Eigen::Vector3f &B, float radius, float &d_c)
+{
+    // Occupancy of an inner node is the maximal occupancy of its children, thus a free node has no occupied leaves
+    if (d_c <= 0 || !octree->isNodeOccupied(node))
+        return;
+
+    float d { distanceLineSegToAABB(A, B, bv) - radius };
+    if (d >= d_c)
+        return;
+
+    if (!octree->nodeHasChildren(node))
+    {
+        d_c = d;
+        return;
+    }
+
+    // Children are visited from the closest one, so that the remaining ones are pruned as early as possible
+    std::array<std::pair<float, unsigned int>, 8> children {};
+    std::array<fcl::AABBf, 8> children_bv {};
+    size_t num_children { 0 };
+    for (unsigned int i = 0; i < 8; i++)
+    {
+        if (!octree->nodeChildExists(node, i))
+            continue;
+        
+        fcl::computeChildBV(bv, i, children_bv[i]);
+        children[num_children++] = { distanceLineSegToAABB(A, B, children_bv[i]), i };
+    }
+    std::sort(children.begin(), children.begin() + num_children);
+
+    for (size_t i = 0; i < num_children; i++)
+    {
+        if (children[i].first - radius >= d_c)
+            break;
+        
+        computeOctreeDistance(octree->getNodeChild(node, children[i].second), children_bv[children[i].second], A, B, radius, d_c);
+    }
+}
+
+// The distance from a point to an AABB is convex along the line segment AB, 
+// thus its minimum is found using the golden-section search.
+float sim_bringup::RealVectorSpaceOctree::distanceLineSegToAABB(const Eigen::Vector3f &A, const Eigen::Vector3f &B, const fcl::AABBf &bv)
+{
+    auto distanceToAABB = [&bv](const Eigen::Vector3f &P) -> float
+    {
+        return (P - P.cwiseMax(bv.min_).cwiseMin(bv.max_)).norm();
+    };
+
+    const float ratio { 0.618034 };
+    const float tol { 1e-4 };
+    float t_min { 0 }, t_max { 1 };
+    float t1 { t_max - ratio * (t_max - t_min) };
+    float t2 { t_min + ratio * (t_max - t_min) };
+    float d1 { distanceToAABB(A + t1 * (B - A)) };
+    float d2 { distanceToAABB(A + t2 * (B - A)) };
+
+    while ((t_max - t_min) * (B - A).norm() > tol)
+    {
+        if (d1 < d2)
+        {
+            t_max = t2;
+            t2 = t1; d2 = d1;
+            t1 = t_max - ratio * (t_max - t_min);
+            d1 = distanceToAABB(A + t1 * (B - A));
+        }
+        else
+        {
+            t_min = t1;
+            t1 = t2; d1 = d2;
+            t2 = t_min + ratio * (t_max - t_min);
+            d2 = distanceToAABB(A + t2 * (B - A));
+        }
+        if (d1 == 0 || d2 == 0)
+            return 0;
+    }
+
+    return std::min({ d1, d2, distanceToAABB(A), distanceToAABB(B) });
+}